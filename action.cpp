@@ -0,0 +1,159 @@
+#include "action.hpp"
+
+namespace ariel
+{
+
+    Action Action::rollDice()
+    {
+        return Action(ActionType::RollDice);
+    }
+
+    Action Action::placeSettlement(int vertexId)
+    {
+        Action action(ActionType::PlaceSettlement);
+        action.location = vertexId;
+        return action;
+    }
+
+    Action Action::placeRoad(int edgeId)
+    {
+        Action action(ActionType::PlaceRoad);
+        action.location = edgeId;
+        return action;
+    }
+
+    Action Action::upgradeSettlement(int vertexId)
+    {
+        Action action(ActionType::UpgradeSettlement);
+        action.location = vertexId;
+        return action;
+    }
+
+    Action Action::buyDevelopmentCard()
+    {
+        return Action(ActionType::BuyDevelopmentCard);
+    }
+
+    Action Action::playYearOfPlenty(Resource first, Resource second)
+    {
+        Action action(ActionType::PlayYearOfPlenty);
+        action.resource = first;
+        action.secondResource = second;
+        return action;
+    }
+
+    Action Action::playMonopoly(Resource resource)
+    {
+        Action action(ActionType::PlayMonopoly);
+        action.resource = resource;
+        return action;
+    }
+
+    Action Action::playRoadBuilding(int firstEdge, int secondEdge)
+    {
+        Action action(ActionType::PlayRoadBuilding);
+        action.location = firstEdge;
+        action.secondLocation = secondEdge;
+        return action;
+    }
+
+    /**
+     * Creates a resource trade with another player.
+     *
+     * @param otherPlayer The seat index of the player to trade with.
+     * @param give The resource the current player gives away.
+     * @param receive The resource the current player receives.
+     * @param giveAmount The amount given away.
+     * @param receiveAmount The amount received.
+     */
+    Action Action::trade(int otherPlayer, Resource give, Resource receive, int giveAmount, int receiveAmount)
+    {
+        Action action(ActionType::TradeResources);
+        action.otherPlayer = otherPlayer;
+        action.resource = give;
+        action.secondResource = receive;
+        action.amount = giveAmount;
+        action.secondAmount = receiveAmount;
+        return action;
+    }
+
+    /**
+     * Creates a sale of knight cards to another player, paid for in resources.
+     *
+     * @param otherPlayer The seat index of the buyer.
+     * @param knights The number of knight cards sold.
+     * @param resource The resource wanted in return.
+     * @param amount The amount of that resource wanted in return.
+     */
+    Action Action::sellKnight(int otherPlayer, int knights, Resource resource, int amount)
+    {
+        Action action(ActionType::SellKnight);
+        action.otherPlayer = otherPlayer;
+        action.knights = knights;
+        action.resource = resource;
+        action.amount = amount;
+        return action;
+    }
+
+    /**
+     * Creates a purchase of knight cards from another player, paid for in resources.
+     *
+     * @param otherPlayer The seat index of the seller.
+     * @param knights The number of knight cards bought.
+     * @param resource The resource paid.
+     * @param amount The amount of that resource paid.
+     */
+    Action Action::buyKnight(int otherPlayer, int knights, Resource resource, int amount)
+    {
+        Action action(ActionType::BuyKnight);
+        action.otherPlayer = otherPlayer;
+        action.knights = knights;
+        action.resource = resource;
+        action.amount = amount;
+        return action;
+    }
+
+    Action Action::endTurn()
+    {
+        return Action(ActionType::EndTurn);
+    }
+
+    const char *resultMessage(ActionResult result)
+    {
+        switch (result)
+        {
+        case ActionResult::Success:
+            return "Success.";
+        case ActionResult::InvalidLocation:
+            return "Invalid location.";
+        case ActionResult::LocationOccupied:
+            return "Location already occupied.";
+        case ActionResult::NotConnected:
+            return "No road or settlement connected to this location.";
+        case ActionResult::AdjacentSettlement:
+            return "Settlement already connected to an adjacent vertex.";
+        case ActionResult::NotOwnSettlement:
+            return "You do not have a settlement at this location.";
+        case ActionResult::InsufficientResources:
+            return "Insufficient resources.";
+        case ActionResult::NoDevelopmentCard:
+            return "You do not have this development card.";
+        case ActionResult::InvalidPlayer:
+            return "Invalid player to trade with.";
+        case ActionResult::InvalidTrade:
+            return "Invalid trade.";
+        case ActionResult::NoRoadsLeft:
+            return "You have no roads left.";
+        default:
+            return "Invalid action.";
+        }
+    }
+
+    const char *actionName(ActionType type)
+    {
+        static const char *const names[] = {"RollDice", "PlaceSettlement", "PlaceRoad", "UpgradeSettlement",
+                                            "BuyDevelopmentCard", "PlayYearOfPlenty", "PlayMonopoly", "PlayRoadBuilding",
+                                            "TradeResources", "SellKnight", "BuyKnight", "EndTurn"};
+        return (size_t)type < NUM_ACTION_TYPES ? names[(size_t)type] : "Unknown";
+    }
+}
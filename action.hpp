@@ -0,0 +1,87 @@
+#ifndef ACTION_HPP
+#define ACTION_HPP
+
+#include <string>
+
+#include "player.hpp"
+
+using namespace std;
+
+namespace ariel
+{
+
+    // The kinds of actions the current player can apply to a game
+    enum class ActionType
+    {
+        RollDice,
+        PlaceSettlement,
+        PlaceRoad,
+        UpgradeSettlement,
+        BuyDevelopmentCard,
+        PlayYearOfPlenty,
+        PlayMonopoly,
+        PlayRoadBuilding,
+        TradeResources,
+        SellKnight,
+        BuyKnight,
+        EndTurn
+    };
+    const size_t NUM_ACTION_TYPES = 12;
+
+    // The outcome of applying an action
+    enum class ActionResult
+    {
+        Success,
+        InvalidLocation,       // Vertex or edge ID out of range
+        LocationOccupied,      // Vertex or edge already taken
+        NotConnected,          // No own road or settlement next to the location
+        AdjacentSettlement,    // A settlement is one edge away
+        NotOwnSettlement,      // Upgrade target is not the player's settlement
+        InsufficientResources, // Player cannot pay the cost
+        NoDevelopmentCard,     // Player does not hold the card being played
+        InvalidPlayer,         // Trade partner is missing or the player itself
+        InvalidTrade,          // Bad amount in a trade
+        NoRoadsLeft,           // Player has built all of their roads
+        InvalidAction          // Unknown action type
+    };
+
+    // A single game action, described by plain values instead of stream input
+    struct Action
+    {
+        ActionType type;
+        int location;            // Vertex or edge ID (first edge for road building)
+        int secondLocation;      // Second edge ID for road building
+        int otherPlayer;         // Seat index of the trade partner
+        Resource resource;       // Resource given, wanted or chosen
+        Resource secondResource; // Resource received in a trade, second year of plenty pick
+        int amount;              // Amount of the first resource
+        int secondAmount;        // Amount of the second resource
+        int knights;             // Number of knight cards traded
+
+        Action(ActionType type = ActionType::EndTurn)
+            : type(type), location(-1), secondLocation(-1), otherPlayer(-1),
+              resource(Resource::Brick), secondResource(Resource::Brick),
+              amount(0), secondAmount(0), knights(0) {}
+
+        static Action rollDice();
+        static Action placeSettlement(int vertexId);
+        static Action placeRoad(int edgeId);
+        static Action upgradeSettlement(int vertexId);
+        static Action buyDevelopmentCard();
+        static Action playYearOfPlenty(Resource first, Resource second);
+        static Action playMonopoly(Resource resource);
+        static Action playRoadBuilding(int firstEdge, int secondEdge);
+        static Action trade(int otherPlayer, Resource give, Resource receive, int giveAmount, int receiveAmount);
+        static Action sellKnight(int otherPlayer, int knights, Resource resource, int amount);
+        static Action buyKnight(int otherPlayer, int knights, Resource resource, int amount);
+        static Action endTurn();
+    };
+
+    // Returns a human readable description of an action result
+    const char *resultMessage(ActionResult result);
+
+    // Returns the name of an action type, like "PlaceRoad"
+    const char *actionName(ActionType type);
+}
+
+#endif
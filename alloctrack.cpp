@@ -0,0 +1,240 @@
+#include "alloctrack.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+
+namespace ariel
+{
+
+    // Sites that can be registered, including site 0 for unattributed allocations
+    static const size_t MAX_SITES = 256;
+
+    // Counters updated by operator new and delete; zeroed before any code runs
+    struct SiteCounters
+    {
+        atomic<long> allocations;
+        atomic<long> frees;
+        atomic<long> bytes;
+        atomic<long> liveBytes;
+        atomic<long> peakBytes;
+    };
+
+    static SiteCounters totalCounters;
+    static SiteCounters siteCounters[MAX_SITES];
+    static atomic<size_t> numOfSites(1);
+
+    static thread_local size_t currentSite = 0;
+    static thread_local long threadCount = 0;
+
+    // Names of the sites, by index; site 0 has no name
+    static vector<string> &siteNames()
+    {
+        static vector<string> names(1);
+        return names;
+    }
+
+    static mutex &siteLock()
+    {
+        static mutex lock;
+        return lock;
+    }
+
+    static void addAllocation(SiteCounters &counters, long size)
+    {
+        counters.allocations.fetch_add(1, memory_order_relaxed);
+        counters.bytes.fetch_add(size, memory_order_relaxed);
+        long live = counters.liveBytes.fetch_add(size, memory_order_relaxed) + size;
+        long peak = counters.peakBytes.load(memory_order_relaxed);
+        while (live > peak && !counters.peakBytes.compare_exchange_weak(peak, live, memory_order_relaxed))
+        {
+        }
+    }
+
+    static void addFree(SiteCounters &counters, long size)
+    {
+        counters.frees.fetch_add(1, memory_order_relaxed);
+        counters.liveBytes.fetch_sub(size, memory_order_relaxed);
+    }
+
+    static AllocationStats snapshot(const SiteCounters &counters)
+    {
+        AllocationStats stats;
+        stats.allocations = counters.allocations.load(memory_order_relaxed);
+        stats.frees = counters.frees.load(memory_order_relaxed);
+        stats.bytes = counters.bytes.load(memory_order_relaxed);
+        stats.liveBytes = counters.liveBytes.load(memory_order_relaxed);
+        stats.peakBytes = counters.peakBytes.load(memory_order_relaxed);
+        return stats;
+    }
+
+    size_t AllocationTracker::registerSite(const string &name)
+    {
+        lock_guard<mutex> guard(siteLock());
+        vector<string> &names = siteNames();
+        for (size_t i = 1; i < names.size(); i++)
+        {
+            if (names[i] == name)
+            {
+                return i;
+            }
+        }
+        if (names.size() >= MAX_SITES)
+        {
+            throw length_error("Too many allocation sites");
+        }
+        names.push_back(name);
+        numOfSites.store(names.size());
+        return names.size() - 1;
+    }
+
+    AllocationStats AllocationTracker::totals()
+    {
+        return snapshot(totalCounters);
+    }
+
+    AllocationStats AllocationTracker::site(const string &name)
+    {
+        lock_guard<mutex> guard(siteLock());
+        vector<string> &names = siteNames();
+        for (size_t i = 1; i < names.size(); i++)
+        {
+            if (names[i] == name)
+            {
+                return snapshot(siteCounters[i]);
+            }
+        }
+        return AllocationStats();
+    }
+
+    vector<pair<string, AllocationStats>> AllocationTracker::sites()
+    {
+        lock_guard<mutex> guard(siteLock());
+        vector<string> &names = siteNames();
+        vector<pair<string, AllocationStats>> result;
+        for (size_t i = 1; i < names.size(); i++)
+        {
+            result.push_back(make_pair(names[i], snapshot(siteCounters[i])));
+        }
+        return result;
+    }
+
+    long AllocationTracker::threadAllocations()
+    {
+        return threadCount;
+    }
+
+    /**
+     * Starts counting afresh. Live bytes are kept, since the memory they count is
+     * still allocated and will be freed later; the peak restarts from them.
+     */
+    void AllocationTracker::reset()
+    {
+        SiteCounters *all[MAX_SITES + 1];
+        size_t count = numOfSites.load();
+        all[0] = &totalCounters;
+        for (size_t i = 0; i < count; i++)
+        {
+            all[i + 1] = &siteCounters[i];
+        }
+        for (size_t i = 0; i <= count; i++)
+        {
+            all[i]->allocations.store(0);
+            all[i]->frees.store(0);
+            all[i]->bytes.store(0);
+            all[i]->peakBytes.store(all[i]->liveBytes.load());
+        }
+    }
+
+    AllocationScope::AllocationScope(size_t site) : previous(currentSite)
+    {
+        currentSite = site;
+    }
+
+    AllocationScope::~AllocationScope()
+    {
+        currentSite = previous;
+    }
+
+    // Placed before every block so that delete knows its size and site; 16 bytes
+    // keep the memory after it as aligned as malloc's
+    struct alignas(16) BlockHeader
+    {
+        size_t size;
+        size_t site;
+    };
+
+    static void *allocate(size_t size)
+    {
+        BlockHeader *header = (BlockHeader *)malloc(sizeof(BlockHeader) + size);
+        if (!header)
+        {
+            return nullptr;
+        }
+        header->size = size;
+        header->site = currentSite;
+        threadCount++;
+        addAllocation(totalCounters, (long)size);
+        addAllocation(siteCounters[header->site], (long)size);
+        return header + 1;
+    }
+
+    static void release(void *memory)
+    {
+        if (!memory)
+        {
+            return;
+        }
+        BlockHeader *header = (BlockHeader *)memory - 1;
+        addFree(totalCounters, (long)header->size);
+        addFree(siteCounters[header->site], (long)header->size);
+        free(header);
+    }
+}
+
+void *operator new(size_t size)
+{
+    void *memory = ariel::allocate(size);
+    if (!memory)
+    {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+void *operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void *operator new(size_t size, const std::nothrow_t &) noexcept
+{
+    return ariel::allocate(size);
+}
+
+void *operator new[](size_t size, const std::nothrow_t &) noexcept
+{
+    return ariel::allocate(size);
+}
+
+void operator delete(void *memory) noexcept
+{
+    ariel::release(memory);
+}
+
+void operator delete[](void *memory) noexcept
+{
+    ariel::release(memory);
+}
+
+void operator delete(void *memory, const std::nothrow_t &) noexcept
+{
+    ariel::release(memory);
+}
+
+void operator delete[](void *memory, const std::nothrow_t &) noexcept
+{
+    ariel::release(memory);
+}
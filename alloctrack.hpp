@@ -0,0 +1,86 @@
+#ifndef ALLOCTRACK_HPP
+#define ALLOCTRACK_HPP
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+namespace ariel
+{
+
+    // Heap use of the whole program or of one allocation site
+    struct AllocationStats
+    {
+        long allocations; // Calls to operator new
+        long frees;       // Calls to operator delete on memory from operator new
+        long bytes;       // Bytes requested in total
+        long liveBytes;   // Bytes allocated and not yet freed
+        long peakBytes;   // Highest value of liveBytes so far
+    };
+
+    // Counts heap allocations by replacing the global operator new and delete. The
+    // counters only exist in programs that link alloctrack.o: microbench and the tests
+    // always do, and every program does in the instrumentation build (make
+    // TRACK_ALLOCATIONS=1). That build also compiles the TRACK_ALLOCATIONS scopes of
+    // the engine's entry points, so allocations are attributed to Board::Board,
+    // Catan::Catan, each action type and resource production.
+    class AllocationTracker
+    {
+    public:
+        // Returns the index of a named site, registering it on first use
+        static size_t registerSite(const string &name);
+
+        // Counters of the whole program
+        static AllocationStats totals();
+
+        // Counters of one site; all zero if nothing was attributed to it
+        static AllocationStats site(const string &name);
+
+        // Every registered site with its counters
+        static vector<pair<string, AllocationStats>> sites();
+
+        // Allocations made so far by the calling thread, for zero-allocation checks
+        static long threadAllocations();
+
+        // Zeroes the counters of every site and the totals, except live bytes
+        static void reset();
+    };
+
+    // Attributes the allocations of the calling thread to a site while it lives.
+    // Scopes nest; allocations go to the innermost one.
+    class AllocationScope
+    {
+    private:
+        size_t previous;
+
+    public:
+        explicit AllocationScope(size_t site);
+        ~AllocationScope();
+
+        AllocationScope(const AllocationScope &) = delete;
+        AllocationScope &operator=(const AllocationScope &) = delete;
+    };
+}
+
+// Attributes the allocations until the end of the enclosing block to a named site.
+// Compiled out unless CATAN_TRACK_ALLOCATIONS is defined.
+#ifdef CATAN_TRACK_ALLOCATIONS
+#define TRACK_ALLOCATIONS(name)                                                                    \
+    static const size_t catanAllocationSite = ariel::AllocationTracker::registerSite(name);        \
+    ariel::AllocationScope catanAllocationScope(catanAllocationSite)
+#define TRACK_ALLOCATIONS_AT(site) ariel::AllocationScope catanAllocationScope(site)
+#else
+#define TRACK_ALLOCATIONS(name) \
+    do                          \
+    {                           \
+    } while (0)
+#define TRACK_ALLOCATIONS_AT(site) \
+    do                             \
+    {                              \
+    } while (0)
+#endif
+
+#endif
@@ -0,0 +1,160 @@
+#ifndef BITBOARD_HPP
+#define BITBOARD_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+using namespace std;
+
+namespace ariel
+{
+
+    // Fixed-size set of board locations (vertices or edges), one bit per location.
+    // Set operations on the board become a few word-wide AND/OR instructions.
+    template <size_t Words>
+    class BitBoard
+    {
+    private:
+        uint64_t words[Words];
+
+    public:
+        // Number of locations the set can hold
+        static const int SIZE = (int)(64 * Words);
+
+        BitBoard() : words() {}
+
+        // Returns the set holding only the given location
+        static BitBoard single(int index)
+        {
+            BitBoard result;
+            result.set(index);
+            return result;
+        }
+
+        void set(int index) { words[(size_t)index >> 6] |= 1ULL << (index & 63); }
+        void reset(int index) { words[(size_t)index >> 6] &= ~(1ULL << (index & 63)); }
+        bool test(int index) const { return (words[(size_t)index >> 6] >> (index & 63)) & 1; }
+
+        void clear()
+        {
+            for (auto &word : words)
+            {
+                word = 0;
+            }
+        }
+
+        bool any() const
+        {
+            for (auto word : words)
+            {
+                if (word)
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        bool none() const { return !any(); }
+
+        // Lowest location in the set, or -1 if it is empty
+        int first() const
+        {
+            for (size_t i = 0; i < Words; i++)
+            {
+                if (words[i])
+                {
+                    return (int)(i * 64) + __builtin_ctzll(words[i]);
+                }
+            }
+            return -1;
+        }
+
+        int count() const
+        {
+            int total = 0;
+            for (auto word : words)
+            {
+                total += __builtin_popcountll(word);
+            }
+            return total;
+        }
+
+        // True if the two sets share a location
+        bool intersects(const BitBoard &other) const
+        {
+            for (size_t i = 0; i < Words; i++)
+            {
+                if (words[i] & other.words[i])
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        // Returns the locations in this set that are not in the other
+        BitBoard without(const BitBoard &other) const
+        {
+            BitBoard result;
+            for (size_t i = 0; i < Words; i++)
+            {
+                result.words[i] = words[i] & ~other.words[i];
+            }
+            return result;
+        }
+
+        BitBoard &operator|=(const BitBoard &other)
+        {
+            for (size_t i = 0; i < Words; i++)
+            {
+                words[i] |= other.words[i];
+            }
+            return *this;
+        }
+
+        BitBoard &operator&=(const BitBoard &other)
+        {
+            for (size_t i = 0; i < Words; i++)
+            {
+                words[i] &= other.words[i];
+            }
+            return *this;
+        }
+
+        BitBoard operator|(const BitBoard &other) const { return BitBoard(*this) |= other; }
+        BitBoard operator&(const BitBoard &other) const { return BitBoard(*this) &= other; }
+
+        bool operator==(const BitBoard &other) const
+        {
+            for (size_t i = 0; i < Words; i++)
+            {
+                if (words[i] != other.words[i])
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        bool operator!=(const BitBoard &other) const { return !(*this == other); }
+
+        // Calls f(index) for every location in the set, in increasing order
+        template <typename F>
+        void forEach(F f) const
+        {
+            for (size_t i = 0; i < Words; i++)
+            {
+                for (uint64_t bits = words[i]; bits; bits &= bits - 1)
+                {
+                    f((int)(i * 64) + __builtin_ctzll(bits));
+                }
+            }
+        }
+    };
+
+    typedef BitBoard<1> VertexMask; // The 54 vertices of the board
+    typedef BitBoard<2> EdgeMask;   // The 72 edges of the board
+}
+
+#endif
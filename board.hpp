@@ -8,8 +8,14 @@
 #include <random>
 #include <algorithm>
 #include <stdexcept>
+#include <array>
 
 #include "player.hpp"
+#include "action.hpp"
+#include "rng.hpp"
+#include "bitboard.hpp"
+#include "topology.hpp"
+#include "zobrist.hpp"
 
 using namespace std;
 
@@ -21,72 +27,173 @@ namespace ariel
     {
     public:
         string type;          // Resource type of the tile (e.g., wood, brick)
+        Resource resource;    // Resource produced by the tile, unless it is the desert
+        bool desert;          // True for the desert, which produces nothing
         int number;           // Dice number associated with the tile
-        vector<int> vertices; // Indices of the vertices adjacent to the tile
-        vector<int> edges;    // Indices of the edges adjacent to the tile
 
         Tile() = default;
-        Tile(const string &type, int number) : type(type), number(number) {}
+        Tile(const string &type, int number) : type(type), resource(Resource::Brick), number(number)
+        {
+            desert = !parseResource(type, resource);
+        }
     };
 
-    // Represents a Vertex in the game board
+    // Type of structure built on a vertex
+    enum class Building : uint8_t
+    {
+        None,
+        Settlement,
+        City
+    };
+
+    // Represents a Vertex in the game board; its neighbors are in the Topology tables
     class Vertex
     {
     public:
-        int id;                        // Unique identifier for the vertex
-        string owner;                  // Player who owns the vertex
-        string type;                   // Type of structure at the vertex (e.g., settlement, city)
-        vector<int> neighbors_vertice; // Indices of neighboring vertices
-        vector<int> neighbors_edges;   // Indices of neighboring edges
-
-        Vertex(int id) : id(id), owner(""), type("") {}
-
-        bool hasSettlement() const { return !owner.empty(); }
-        bool isCity() const { return type == "city"; }
-        bool isSettlement() const { return type == "settlement"; }
-        void setOwner(const string &player) { owner = player; }
-        void setType(const string &type) { this->type = type; }
-        string getOwner() const { return owner; }
-        string getType() const { return type; }
+        int id;        // Unique identifier for the vertex
+        uint8_t owner; // Index of the player who owns the vertex
+        Building type; // Type of structure at the vertex
+
+        Vertex(int id = 0) : id(id), owner(NO_PLAYER), type(Building::None) {}
+
+        bool hasSettlement() const { return owner != NO_PLAYER; }
+        bool isCity() const { return type == Building::City; }
+        bool isSettlement() const { return type == Building::Settlement; }
+        void setOwner(uint8_t player) { owner = player; }
+        void setType(Building type) { this->type = type; }
+        uint8_t getOwner() const { return owner; }
+        string getType() const { return type == Building::City ? "city" : type == Building::Settlement ? "settlement" : ""; }
     };
 
-    // Represents an Edge in the game board
+    // Represents an Edge in the game board; its neighbors are in the Topology tables
     class Edge
     {
     public:
-        int id;                        // Unique identifier for the edge
-        string owner;                  // Player who owns the edge
-        vector<int> neighbors_vertice; // Indices of neighboring vertices
-        vector<int> neighbors_edges;   // Indices of neighboring edges
+        int id;        // Unique identifier for the edge
+        uint8_t owner; // Index of the player who owns the edge
+
+        Edge(int id = 0) : id(id), owner(NO_PLAYER) {}
+    };
+
+    // A building that produces resources when the number of one of its tiles is rolled
+    struct Production
+    {
+        int vertex;        // Vertex holding the building
+        uint8_t owner;     // Index of the player who receives the resources
+        Resource resource; // Resource produced by the tile
+        int amount;        // 1 for a settlement, 2 for a city
+    };
 
-        Edge(int id) : id(id), owner("") {}
+    // Roads each player has to build with
+    const int MAX_ROADS = 15;
+
+    // The roads of one player that are connected to each other, and the longest
+    // road through them. Roads are connected through a shared vertex unless another
+    // player has built on it.
+    struct RoadNetwork
+    {
+        EdgeMask edges;
+        int length;
+    };
+
+    // Adjacency of the standard board as bitboards, built once from the Topology tables
+    struct AdjacencyMasks
+    {
+        array<VertexMask, NUM_VERTICES> vertexNeighbors; // Vertices one edge away from each vertex
+        array<EdgeMask, NUM_VERTICES> vertexEdges;       // Edges touching each vertex
+        array<EdgeMask, NUM_EDGES> edgeNeighbors;        // Edges sharing a vertex with each edge
+        array<VertexMask, NUM_EDGES> edgeVertices;       // End points of each edge
+
+        AdjacencyMasks();
     };
 
+    // Returns the adjacency bitboards shared by every board
+    const AdjacencyMasks &adjacencyMasks();
+
+    class Journal;
+
     // Represents the game board
     class Board
     {
+        friend class GameState;
+        friend class Journal;
+
     private:
-        vector<vector<Tile>> tiles; // 2D grid of tiles
-        vector<Vertex> vertices;    // List of all vertices
-        vector<Edge> edges;         // List of all edges
-        void initializeVerticesNeighbors();
-        void initializeEdgesNeighbors();
+        array<Tile, NUM_TILES> tiles;             // Tiles row by row, in rows of 3, 4, 5, 4 and 3
+        array<Vertex, NUM_VERTICES> vertices;     // List of all vertices
+        array<Edge, NUM_EDGES> edges;             // List of all edges
+        array<vector<Production>, 13> production; // Buildings to credit, indexed by dice number
+
+        // Occupancy bitboards, kept in step with the owners of the vertices and edges
+        VertexMask buildings;               // Every settlement and city
+        EdgeMask roads;                     // Every road
+        vector<VertexMask> settlementMasks; // Settlements of each player, indexed by player ID
+        vector<VertexMask> cityMasks;       // Cities of each player, indexed by player ID
+        vector<EdgeMask> roadMasks;         // Roads of each player, indexed by player ID
+
+        // Legal-move sets, updated on every placement
+        VertexMask openVertices;                 // Free vertices with no building next to them
+        vector<VertexMask> legalSettlementMasks; // Open vertices at the end of each player's roads
+        vector<EdgeMask> legalRoadMasks;         // Free edges touching each player's buildings, or their roads away from other players' buildings
+
+        // Road networks of each player with their longest roads, updated on every placement
+        vector<vector<RoadNetwork>> roadNetworks;
+
+        uint64_t hash;    // Zobrist hash of the settlements, cities and roads
+        Journal *journal; // Receives every placement while a move is recorded, if set
+
+        void initializeProductionIndex();
+        void initializeMasks();
+        void ensurePlayerMasks(uint8_t player);
+        void journalLegalSets();
+        VertexMask blockedFor(uint8_t player) const;
+        void addRoadNetworks(uint8_t player, EdgeMask roads);
+        void extendRoadNetwork(uint8_t player, int edgeId);
+        void splitRoadNetworks(uint8_t owner, int vertexId);
+        void rebuildRoadNetworks(uint8_t player);
+        EdgeMask roadExtensions(uint8_t player, int edgeId) const;
+        bool connectsRoad(uint8_t player, int edgeId) const;
 
     public:
         vector<string> initializeResources();
 
         void shuffleResources(vector<string> &resources);
 
+        // Shuffles the resources using the given random number generator
+        void shuffleResources(vector<string> &resources, Rng &rng);
+
         Board();
 
+        // Creates a board whose tiles are shuffled by the given random number generator
+        explicit Board(Rng &rng);
+
         // Initializes the board with tiles, vertices, and edges
         void initialize();
 
+        // Initializes the board, shuffling the tiles with the given random number generator
+        void initialize(Rng &rng);
+
+        // Removes every settlement, city and road, keeping the tiles
+        void clearPieces();
+
         // Places a settlement on the specified vertex
         bool placeSettlement(int vertexId, Player &player, bool firstTurn);
 
+        // Checks whether a settlement may be placed on the specified vertex
+        ActionResult validateSettlement(int vertexId, Player &player, bool firstTurn) const;
+
+        // Checks whether a road may be placed on the specified edge
+        ActionResult validateRoad(int edgeId, Player &player) const;
+
+        // Checks whether an edge continues a road through a vertex that holds no other player's building
+        bool extendsRoad(int edgeId, int roadEdgeId, uint8_t player) const;
+
+        // Checks whether the settlement on the specified vertex may be upgraded
+        ActionResult validateUpgrade(int vertexId, Player &player) const;
+
         // Checks if a vertex is occupied by any player
         bool isVertexOccupied(const Vertex &vertex) const;
+        bool isVertexOccupied(int vertexId) const;
 
         // Checks if a vertex is connected to a player's road
         bool isConnectedToPlayerRoad(const Vertex &vertex, Player &player) const;
@@ -102,6 +209,7 @@ namespace ariel
 
         // Checks if an edge is occupied by any player
         bool isEdgeOccupied(const Edge &edge) const;
+        bool isEdgeOccupied(int edgeId) const;
 
         // Checks if an edge is connected to a player's road
         bool isConnectedToPlayerRoad(const Edge &edge, Player &player) const;
@@ -124,8 +232,20 @@ namespace ariel
         // Gives resources to a player based on the dice result
         void giveResources(Player &player, int result);
 
-        // Assigns vertices to tiles
-        void assignVerticesAndEdgesToTiles();
+        // Gives resources to every player based on the dice result; players are indexed by their ID
+        void produce(vector<Player> &players, int result);
+
+        // Gets the buildings that produce when the given number is rolled
+        const vector<Production> &getProduction(int result) const;
+
+        // Adjacency lists of a vertex, an edge or a tile
+        const IdList<3> &getVertexTiles(int vertexId) const;
+        const IdList<3> &getVertexNeighbors(int vertexId) const;
+        const IdList<3> &getVertexEdges(int vertexId) const;
+        const IdList<2> &getEdgeVertices(int edgeId) const;
+        const IdList<4> &getEdgeNeighbors(int edgeId) const;
+        const IdList<6> &getTileVertices(int tileIndex) const;
+        const IdList<6> &getTileEdges(int tileIndex) const;
 
         // Checks if a player has a valid settlement location
         bool isValidSettlementLocation(int vertexId);
@@ -133,18 +253,52 @@ namespace ariel
         // Checks if a player has a valid road location
         bool isValidRoadLocation(int edgeId);
 
-        // Prints the board
-        void printBoard();
+        // Prints the board, using the given table to turn player indices into names
+        void printBoard(const vector<string> &playerNames);
+
+        // Prints the resource and dice number of every tile
+        void printTiles();
 
         // Checks if an edge is connected to a player's settlement
         bool isConnectedToPlayerSettlement(const Edge &edge, Player &player) const;
 
+        // Occupancy bitboards; a player without buildings gets an empty mask
+        const VertexMask &getBuildingsMask() const;
+        const EdgeMask &getRoadsMask() const;
+        const VertexMask &getSettlementsMask(uint8_t player) const;
+        const VertexMask &getCitiesMask(uint8_t player) const;
+        const EdgeMask &getRoadsMask(uint8_t player) const;
+
+        // Where a player may build, regardless of cost. During the setup rounds any open
+        // vertex may take a settlement; afterwards it must touch one of the player's roads.
+        // A player who has built all MAX_ROADS roads has no legal roads.
+        const VertexMask &getLegalSettlements(uint8_t player, bool firstRound) const;
+        const EdgeMask &getLegalRoads(uint8_t player) const;
+        const VertexMask &getLegalUpgrades(uint8_t player) const;
+
+        // Adjacency bitboards of a vertex or an edge
+        const VertexMask &getVertexNeighborMask(int vertexId) const;
+        const EdgeMask &getVertexEdgeMask(int vertexId) const;
+        const EdgeMask &getEdgeNeighborMask(int edgeId) const;
+        const VertexMask &getEdgeVertexMask(int edgeId) const;
+
         int getTilesSize() const;
 
         int getVerticesSize() const;
 
         int getEdgesSize() const;
 
+        // Number of roads the player can still build
+        int getRoadsLeft(uint8_t player) const;
+
+        // Number of roads on the player's longest road
+        int getLongestRoad(uint8_t player) const;
+
+        // Zobrist hash of every settlement, city and road, kept up to date on each placement
+        uint64_t getHash() const;
+
+        // Reports every placement to the journal; null stops it
+        void setJournal(Journal *journal);
     };
 }
 
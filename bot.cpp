@@ -0,0 +1,360 @@
+#include "bot.hpp"
+#include "mcts.hpp"
+#include "evaluator.hpp"
+
+namespace ariel
+{
+
+    /**
+     * Returns all vertices where the player may place a settlement right now.
+     *
+     * @param game The game to inspect.
+     * @param player The player who would build.
+     * @param firstRound True during the setup rounds, when no road is needed.
+     * @return The IDs of the legal vertices.
+     */
+    vector<int> legalSettlements(Catan &game, Player &player, bool firstRound)
+    {
+        vector<int> result;
+        game.getBoard().getLegalSettlements(player.getId(), firstRound).forEach([&](int v) { result.push_back(v); });
+        return result;
+    }
+
+    /**
+     * Returns all edges where the player may place a road right now.
+     *
+     * @param game The game to inspect.
+     * @param player The player who would build.
+     * @return The IDs of the legal edges.
+     */
+    vector<int> legalRoads(Catan &game, Player &player)
+    {
+        vector<int> result;
+        game.getBoard().getLegalRoads(player.getId()).forEach([&](int e) { result.push_back(e); });
+        return result;
+    }
+
+    /**
+     * Returns the vertices holding the player's settlements, which may be upgraded.
+     *
+     * @param game The game to inspect.
+     * @param player The owner of the settlements.
+     * @return The IDs of the vertices.
+     */
+    vector<int> ownSettlements(Catan &game, Player &player)
+    {
+        vector<int> result;
+        game.getBoard().getLegalUpgrades(player.getId()).forEach([&](int v) { result.push_back(v); });
+        return result;
+    }
+
+    /**
+     * Counts the dice combinations (out of 36) that produce at a vertex.
+     *
+     * @param board The game board.
+     * @param vertexId The vertex to rate.
+     * @return The sum of the pips of the producing tiles around the vertex.
+     */
+    int vertexPips(Board &board, int vertexId)
+    {
+        int pips = 0;
+        for (int tileIndex : board.getVertexTiles(vertexId))
+        {
+            const Tile &tile = board.getTile(tileIndex);
+            if (!tile.desert)
+            {
+                pips += 6 - abs(7 - tile.number);
+            }
+        }
+        return pips;
+    }
+
+    // Returns the free edges touching a vertex
+    static vector<int> freeEdgesAround(Board &board, int vertexId)
+    {
+        vector<int> result;
+        for (int edgeId : board.getVertexEdges(vertexId))
+        {
+            if (!board.isEdgeOccupied(board.getEdge(edgeId)))
+            {
+                result.push_back(edgeId);
+            }
+        }
+        return result;
+    }
+
+    // Returns the vertex with the most pips from a list, or -1 for an empty list
+    static int bestVertex(Board &board, const vector<int> &candidates)
+    {
+        int best = -1;
+        int bestPips = -1;
+        for (int v : candidates)
+        {
+            int pips = vertexPips(board, v);
+            if (pips > bestPips)
+            {
+                best = v;
+                bestPips = pips;
+            }
+        }
+        return best;
+    }
+
+    // Rates a road by the settlement spots it opens up: a free spot at its end counts double
+    static int roadScore(Board &board, int edgeId)
+    {
+        int score = 0;
+        for (int v : board.getEdgeVertices(edgeId))
+        {
+            if (board.isValidSettlementLocation(v))
+            {
+                score = max(score, 2 * vertexPips(board, v));
+            }
+            for (int n : board.getVertexNeighbors(v))
+            {
+                if (board.isValidSettlementLocation(n))
+                {
+                    score = max(score, vertexPips(board, n));
+                }
+            }
+        }
+        return score;
+    }
+
+    // Returns the road with the best score from a list, or -1 for an empty list
+    static int bestRoad(Board &board, const vector<int> &candidates, int excluded = -1)
+    {
+        int best = -1;
+        int bestScore = -1;
+        for (int e : candidates)
+        {
+            int score = roadScore(board, e);
+            if (e != excluded && score > bestScore)
+            {
+                best = e;
+                bestScore = score;
+            }
+        }
+        return best;
+    }
+
+    static Resource randomResource(Rng &rng)
+    {
+        return (Resource)rng.below((uint32_t)NUM_RESOURCES);
+    }
+
+    const char *RandomBot::getName() const
+    {
+        return "random";
+    }
+
+    int RandomBot::chooseSetupSettlement(Catan &game, Rng &rng)
+    {
+        vector<int> options = legalSettlements(game, game.getCurrentPlayer(), true);
+        return options.empty() ? -1 : options[rng.below((uint32_t)options.size())];
+    }
+
+    int RandomBot::chooseSetupRoad(Catan &game, int settlement, Rng &rng)
+    {
+        vector<int> options = freeEdgesAround(game.getBoard(), settlement);
+        return options.empty() ? -1 : options[rng.below((uint32_t)options.size())];
+    }
+
+    /**
+     * Lists every affordable action and picks one of them uniformly at random.
+     * Ending the turn is always one of the options.
+     */
+    Action RandomBot::chooseAction(Catan &game, Rng &rng)
+    {
+        Player &player = game.getCurrentPlayer();
+        vector<Action> options;
+        options.push_back(Action::endTurn());
+
+        if (player.hasEnoughResources(Purchase::City))
+        {
+            for (int v : ownSettlements(game, player))
+            {
+                options.push_back(Action::upgradeSettlement(v));
+            }
+        }
+        if (player.hasEnoughResources(Purchase::Settlement))
+        {
+            for (int v : legalSettlements(game, player, false))
+            {
+                options.push_back(Action::placeSettlement(v));
+            }
+        }
+        vector<int> roads = legalRoads(game, player);
+        if (player.hasEnoughResources(Purchase::Road))
+        {
+            for (int e : roads)
+            {
+                options.push_back(Action::placeRoad(e));
+            }
+        }
+        if (player.hasEnoughResources(Purchase::DevelopmentCard))
+        {
+            options.push_back(Action::buyDevelopmentCard());
+        }
+        if (player.hasDevelopmentCard(DevCard::YearOfPlenty))
+        {
+            options.push_back(Action::playYearOfPlenty(randomResource(rng), randomResource(rng)));
+        }
+        if (player.hasDevelopmentCard(DevCard::Monopoly))
+        {
+            options.push_back(Action::playMonopoly(randomResource(rng)));
+        }
+        if (player.hasDevelopmentCard(DevCard::RoadBuilding) && roads.size() >= 2 && game.getBoard().getRoadsLeft(player.getId()) >= 2)
+        {
+            size_t first = rng.below((uint32_t)roads.size());
+            size_t second = (first + 1 + rng.below((uint32_t)roads.size() - 1)) % roads.size();
+            options.push_back(Action::playRoadBuilding(roads[first], roads[second]));
+        }
+
+        return options[rng.below((uint32_t)options.size())];
+    }
+
+    const char *GreedyBot::getName() const
+    {
+        return "greedy";
+    }
+
+    /**
+     * Plans both setup settlements together: the first is the better half of the best
+     * legal pair, and the second the spot that best complements the first.
+     */
+    int GreedyBot::chooseSetupSettlement(Catan &game, Rng &)
+    {
+        Board &board = game.getBoard();
+        uint8_t id = game.getCurrentPlayer().getId();
+        VertexEvaluator evaluator(board);
+        const VertexMask &legal = board.getLegalSettlements(id, true);
+        int owned = board.getSettlementsMask(id).first();
+        if (owned < 0)
+        {
+            pair<int, int> best = evaluator.bestPair(legal);
+            return best.first >= 0 ? best.first : evaluator.bestVertex(legal);
+        }
+        return evaluator.bestPartner(owned, legal);
+    }
+
+    int GreedyBot::chooseSetupRoad(Catan &game, int settlement, Rng &)
+    {
+        return bestRoad(game.getBoard(), freeEdgesAround(game.getBoard(), settlement));
+    }
+
+    /**
+     * Builds in order of value: city, settlement, development card plays,
+     * development card purchase, and a road only when no settlement spot is reachable.
+     */
+    Action GreedyBot::chooseAction(Catan &game, Rng &)
+    {
+        Player &player = game.getCurrentPlayer();
+        Board &board = game.getBoard();
+
+        // A city is worth a point and doubles production
+        if (player.hasEnoughResources(Purchase::City))
+        {
+            int v = bestVertex(board, ownSettlements(game, player));
+            if (v >= 0)
+            {
+                return Action::upgradeSettlement(v);
+            }
+        }
+
+        // A settlement is worth a point
+        vector<int> spots = legalSettlements(game, player, false);
+        if (player.hasEnoughResources(Purchase::Settlement) && !spots.empty())
+        {
+            return Action::placeSettlement(bestVertex(board, spots));
+        }
+
+        // Take the two resources the player has the fewest of
+        if (player.hasDevelopmentCard(DevCard::YearOfPlenty))
+        {
+            Resource first = Resource::Brick;
+            for (size_t r = 0; r < NUM_RESOURCES; r++)
+            {
+                if (player.amountOfResources((Resource)r) < player.amountOfResources(first))
+                {
+                    first = (Resource)r;
+                }
+            }
+            Resource second = first == Resource::Brick ? Resource::Grain : Resource::Brick;
+            for (size_t r = 0; r < NUM_RESOURCES; r++)
+            {
+                if ((Resource)r != first && player.amountOfResources((Resource)r) < player.amountOfResources(second))
+                {
+                    second = (Resource)r;
+                }
+            }
+            return Action::playYearOfPlenty(first, second);
+        }
+
+        // Take the resource the other players hold the most of
+        if (player.hasDevelopmentCard(DevCard::Monopoly))
+        {
+            Resource best = Resource::Brick;
+            int bestAmount = -1;
+            for (size_t r = 0; r < NUM_RESOURCES; r++)
+            {
+                int amount = 0;
+                for (size_t i = 0; i < game.getNumOfPlayers(); i++)
+                {
+                    if (i != player.getId())
+                    {
+                        amount += game.getPlayer(i).amountOfResources((Resource)r);
+                    }
+                }
+                if (amount > bestAmount)
+                {
+                    best = (Resource)r;
+                    bestAmount = amount;
+                }
+            }
+            return Action::playMonopoly(best);
+        }
+
+        vector<int> roads = legalRoads(game, player);
+        if (player.hasDevelopmentCard(DevCard::RoadBuilding) && roads.size() >= 2 && board.getRoadsLeft(player.getId()) >= 2)
+        {
+            int first = bestRoad(board, roads);
+            return Action::playRoadBuilding(first, bestRoad(board, roads, first));
+        }
+
+        if (player.hasEnoughResources(Purchase::DevelopmentCard))
+        {
+            return Action::buyDevelopmentCard();
+        }
+
+        // Extend the road network only when there is nowhere to build
+        if (player.hasEnoughResources(Purchase::Road) && spots.empty() && !roads.empty())
+        {
+            return Action::placeRoad(bestRoad(board, roads));
+        }
+
+        return Action::endTurn();
+    }
+
+    unique_ptr<Bot> createBot(const string &name)
+    {
+        if (name == "random")
+        {
+            return unique_ptr<Bot>(new RandomBot());
+        }
+        if (name == "greedy")
+        {
+            return unique_ptr<Bot>(new GreedyBot());
+        }
+        if (name == "mcts")
+        {
+            // A fixed budget on one thread keeps games reproducible and lets the
+            // simulator spread games over the cores instead
+            MctsConfig config;
+            config.iterations = 1000;
+            config.threads = 1;
+            return unique_ptr<Bot>(new MctsBot(config));
+        }
+        return unique_ptr<Bot>();
+    }
+}
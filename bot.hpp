@@ -0,0 +1,68 @@
+#ifndef BOT_HPP
+#define BOT_HPP
+
+#include <string>
+#include <vector>
+#include <memory>
+
+#include "catan.hpp"
+#include "action.hpp"
+#include "rng.hpp"
+
+using namespace std;
+
+namespace ariel
+{
+
+    // A scripted player that picks actions for the current player of a game
+    class Bot
+    {
+    public:
+        virtual ~Bot() {}
+
+        // Name of the strategy, used in reports
+        virtual const char *getName() const = 0;
+
+        // Chooses the vertex of a free settlement during the setup rounds
+        virtual int chooseSetupSettlement(Catan &game, Rng &rng) = 0;
+
+        // Chooses the edge of the road built next to the settlement just placed
+        virtual int chooseSetupRoad(Catan &game, int settlement, Rng &rng) = 0;
+
+        // Chooses the next action of the current turn; ActionType::EndTurn ends the turn
+        virtual Action chooseAction(Catan &game, Rng &rng) = 0;
+    };
+
+    // Picks uniformly among all legal actions, including ending the turn
+    class RandomBot : public Bot
+    {
+    public:
+        const char *getName() const override;
+        int chooseSetupSettlement(Catan &game, Rng &rng) override;
+        int chooseSetupRoad(Catan &game, int settlement, Rng &rng) override;
+        Action chooseAction(Catan &game, Rng &rng) override;
+    };
+
+    // Always takes the most valuable build it can afford, preferring productive vertices
+    class GreedyBot : public Bot
+    {
+    public:
+        const char *getName() const override;
+        int chooseSetupSettlement(Catan &game, Rng &rng) override;
+        int chooseSetupRoad(Catan &game, int settlement, Rng &rng) override;
+        Action chooseAction(Catan &game, Rng &rng) override;
+    };
+
+    // Creates a bot from its strategy name ("random", "greedy" or "mcts"); returns null for unknown names
+    unique_ptr<Bot> createBot(const string &name);
+
+    // Legal move helpers shared by the bots
+    vector<int> legalSettlements(Catan &game, Player &player, bool firstRound);
+    vector<int> legalRoads(Catan &game, Player &player);
+    vector<int> ownSettlements(Catan &game, Player &player);
+
+    // Expected production of a vertex: the number of dice combinations that pay out there
+    int vertexPips(Board &board, int vertexId);
+}
+
+#endif
@@ -1,25 +1,124 @@
 #include "catan.hpp"
+#include "record.hpp"
+#include "journal.hpp"
+#include "longestroad.hpp"
+#include "log.hpp"
+#include "alloctrack.hpp"
+#include "metrics.hpp"
+
+#include <chrono>
 
 using namespace std;
 
 namespace ariel
 {
 
+#ifdef CATAN_TRACK_ALLOCATIONS
+    // Allocation site of each action type, like "Catan::apply(PlaceRoad)"
+    static size_t allocationSite(ActionType type)
+    {
+        static const vector<size_t> sites = []() {
+            vector<size_t> result;
+            for (size_t i = 0; i < NUM_ACTION_TYPES; i++)
+            {
+                result.push_back(AllocationTracker::registerSite(string("Catan::apply(") + actionName((ActionType)i) + ")"));
+            }
+            return result;
+        }();
+        return sites[(size_t)type];
+    }
+#endif
+
+    /**
+     * Constructs a Catan game with three players and a random seed.
+     *
+     * @param p1 The first player.
+     * @param p2 The second player.
+     * @param p3 The third player.
+     */
+    Catan::Catan(Player &p1, Player &p2, Player &p3) : Catan(vector<Player>{p1, p2, p3}, Rng::randomSeed())
+    {
+    }
+
     /**
      * Constructs a Catan game with three players.
      *
      * @param p1 The first player.
      * @param p2 The second player.
      * @param p3 The third player.
+     * @param seed The seed of the game's random number generator.
+     */
+    Catan::Catan(Player &p1, Player &p2, Player &p3, uint64_t seed) : Catan(vector<Player>{p1, p2, p3}, seed)
+    {
+    }
+
+    /**
+     * Constructs a Catan game with any number of players and a random seed.
+     *
+     * @param players The players, in seat order.
+     */
+    Catan::Catan(const vector<Player> &players) : Catan(players, Rng::randomSeed())
+    {
+    }
+
+    /**
+     * Constructs a Catan game with any number of players.
+     *
+     * All randomness of the game (board layout, starting player, dice, development
+     * cards and discards) comes from one generator seeded with the given seed, so
+     * the same seed and the same actions always produce the same game.
+     *
+     * @param players The players, in seat order.
+     * @param seed The seed of the game's random number generator.
+     * @throws invalid_argument if there are fewer than MIN_PLAYERS or more than MAX_PLAYERS players.
      */
-    Catan::Catan(Player &p1, Player &p2, Player &p3) : currentPlayerIndex(0)
+    Catan::Catan(const vector<Player> &players, uint64_t seed)
+        : seed(seed), rng(seed), board(rng), players(players), currentPlayerIndex(0), longestRoadHolder(NO_PLAYER), record(nullptr), journal(nullptr)
     {
-        // Initialize the vector of players with the given players.
-        players = {p1, p2, p3};
+        TRACK_ALLOCATIONS("Catan::Catan");
+        if (players.size() < MIN_PLAYERS || players.size() > MAX_PLAYERS)
+        {
+            throw invalid_argument("A game needs between " + to_string(MIN_PLAYERS) + " and " + to_string(MAX_PLAYERS) + " players");
+        }
+        assignPlayerIds();
 
         // Initialize the number of knights left to 3.
         knightsLeft = 3;
         VPleft = 4;
+        lastRoll = 0;
+        lastDevelopmentCard = DevCard::Knight;
+        produced.fill(0);
+    }
+
+    /**
+     * Gives every player the index of their seat and rebuilds the name table.
+     *
+     * The board stores these indices instead of names, so this must be called
+     * whenever the seating order changes.
+     */
+    void Catan::assignPlayerIds()
+    {
+        playerNames.clear();
+        for (size_t i = 0; i < players.size(); i++)
+        {
+            players[i].setId((uint8_t)i);
+            playerNames.push_back(players[i].getName());
+        }
+    }
+
+    const vector<string> &Catan::getPlayerNames() const
+    {
+        return playerNames;
+    }
+
+    uint64_t Catan::getSeed() const
+    {
+        return seed;
+    }
+
+    Rng &Catan::getRng()
+    {
+        return rng;
     }
 
     Board &Catan::getBoard()
@@ -51,11 +150,78 @@ namespace ariel
         return nullptr;
     }
 
+    /**
+     * Returns the seat index of the player with the given name.
+     *
+     * @param name The name of the player to look up.
+     * @return The seat index of the player, or -1 if no player has that name.
+     */
+    int Catan::findPlayerIndexByName(const string &name) const
+    {
+        for (size_t i = 0; i < players.size(); i++)
+        {
+            if (players[i].getName() == name)
+            {
+                return (int)i;
+            }
+        }
+        return -1;
+    }
+
     Player &Catan::getCurrentPlayer()
     {
         return players[(size_t)currentPlayerIndex];
     }
 
+    Player &Catan::getPlayer(size_t index)
+    {
+        if (index >= players.size())
+        {
+            throw invalid_argument("Invalid player index");
+        }
+        return players[index];
+    }
+
+    size_t Catan::getNumOfPlayers() const
+    {
+        return players.size();
+    }
+
+    int Catan::getLastRoll() const
+    {
+        return lastRoll;
+    }
+
+    DevCard Catan::getLastDevelopmentCard() const
+    {
+        return lastDevelopmentCard;
+    }
+
+    const array<int, NUM_RESOURCES> &Catan::getProducedResources() const
+    {
+        return produced;
+    }
+
+    /**
+     * Combines the incrementally maintained hashes of the board and the players with
+     * the keys of the bank and the player to move.
+     *
+     * @return The Zobrist hash of the current position.
+     */
+    uint64_t Catan::getHash() const
+    {
+        uint64_t hash = board.getHash();
+        for (const Player &player : players)
+        {
+            hash ^= player.getHash();
+        }
+        hash ^= zobrist::knightsLeft(knightsLeft);
+        hash ^= zobrist::victoryPointsLeft(VPleft);
+        hash ^= zobrist::currentPlayer(currentPlayerIndex);
+        hash ^= zobrist::longestRoad(longestRoadHolder);
+        return hash;
+    }
+
     /**
      * Checks if any player has achieved 10 points.
      *
@@ -80,28 +246,28 @@ namespace ariel
      * Chooses a random starting player for the game.
      *
      * This function shuffles the list of players and sets the current player index to 0.
-     * It then prints the order of the players to the console.
      *
      * @throws None
      */
     void Catan::ChooseStartingPlayer()
     {
-        // Create a random device and use it to seed a random number generator
-        random_device rd;
-        mt19937 g(rd());
+        // Shuffle the list of players using the game's random number generator
+        rng.shuffle(players);
+        assignPlayerIds();
 
-        // Shuffle the list of players using the random number generator
-        shuffle(players.begin(), players.end(), g);
+        // Reseating cannot be undone, so the history starts over
+        if (journal)
+        {
+            journal->clear();
+        }
+        if (record)
+        {
+            record->recordSeatChange(RecordOp::ChooseStartingPlayer);
+        }
 
         // Set the current player index to 0
         currentPlayerIndex = 0;
-
-        // Print the order of the players to the console
-        cout << "The order of the players is: " << endl;
-        for (auto &player : players)
-        {
-            cout << player.getName() << endl;
-        }
+        LOG_INFO(players[0].getName() << " starts the game");
     }
 
     /**
@@ -113,7 +279,20 @@ namespace ariel
      */
     void Catan::nextPlayer()
     {
+        bool journaling = journal && !journal->isRecording();
+        if (journaling)
+        {
+            journal->begin(*this, RecordOp::NextPlayer, Action());
+        }
         currentPlayerIndex = (currentPlayerIndex + 1) % players.size();
+        if (record)
+        {
+            record->recordSeatChange(RecordOp::NextPlayer);
+        }
+        if (journaling)
+        {
+            journal->commit();
+        }
     }
 
     /**
@@ -125,7 +304,43 @@ namespace ariel
      */
     void Catan::previousPlayer()
     {
+        bool journaling = journal && !journal->isRecording();
+        if (journaling)
+        {
+            journal->begin(*this, RecordOp::PreviousPlayer, Action());
+        }
         currentPlayerIndex = (currentPlayerIndex + players.size() - 1) % players.size();
+        if (record)
+        {
+            record->recordSeatChange(RecordOp::PreviousPlayer);
+        }
+        if (journaling)
+        {
+            journal->commit();
+        }
+    }
+
+    /**
+     * Passes the turn on during the setup rounds: forwards in the first round, backwards
+     * in the second, and not at all between the rounds or after the last placement.
+     *
+     * @param game The game in its setup rounds.
+     * @param step The placement that was just made.
+     */
+    void SetupSchedule::advance(Catan &game, size_t step) const
+    {
+        if (step + 1 >= size() || seat(step + 1) == seat(step))
+        {
+            return;
+        }
+        if (seat(step + 1) > seat(step))
+        {
+            game.nextPlayer();
+        }
+        else
+        {
+            game.previousPlayer();
+        }
     }
 
     /**
@@ -152,7 +367,7 @@ namespace ariel
                 winner = &player;
 
                 // Print the name of the winner to the console
-                cout << "The winner is: " << winner->getName() << endl;
+                cout << "The winner is: " << winner->getName() << '\n';
 
                 // Exit the loop since the winner has been found
                 return;
@@ -160,543 +375,487 @@ namespace ariel
         }
 
         // If no player has reached 10 points, print "No winner yet." to the console
-        cout << "No winner yet." << endl;
+        cout << "No winner yet." << '\n';
     }
 
     /**
-     * Rolls the dice and gives the corresponding resources to each player.
+     * Applies a single action on behalf of the current player.
      *
-     * This function rolls the dice by generating a random number between 2 and 12.
-     * The result is then printed to the console. If the result is 7, the function
-     * calls the `itsSeven` function for each player. Otherwise, the function
-     * gives the corresponding resources to each player by calling the `giveResources`
-     * function of the `Board` class.
+     * This is the programmatic entry point of the engine: every rule is checked and
+     * executed exactly as in the interactive game, but no input is read and nothing
+     * is printed. The caller decides how to present the returned result.
      *
-     * @param board The game board
+     * @param action The action to apply
+     * @return ActionResult::Success if the action was applied, otherwise the reason it was rejected
      */
-    void Catan::rollDice(Board &board)
+    ActionResult Catan::apply(const Action &action)
     {
-        // Generate a random number between 2 and 12
-        srand(time(0));
-        int result = rand() % 6 + 1 + rand() % 6 + 1;
+        TRACK_ALLOCATIONS_AT(allocationSite(action.type));
+        // A move applied from inside another one, like ending the turn, belongs to it
+        bool journaling = journal && !journal->isRecording();
+        if (journaling)
+        {
+            journal->begin(*this, (RecordOp)action.type, action);
+        }
 
-        // Print the dice result to the console
-        cout << "Dice result is: " << result << endl;
+        size_t seat = currentPlayerIndex;
+        ActionResult result;
+        if (Metrics::isEnabled())
+        {
+            auto start = chrono::steady_clock::now();
+            result = applyAction(action);
+            auto elapsed = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start);
+            Metrics::recordAction(action, result, (uint64_t)elapsed.count(), lastRoll);
+        }
+        else
+        {
+            result = applyAction(action);
+        }
+        LOG_DEBUG(players[seat].getName() << ": " << actionName(action.type) << " " << action.location << " -> " << resultMessage(result));
 
-        // If the result is 7, call the `itsSeven` function for each player
-        if (result == 7)
+        if (journaling)
         {
-            for (auto &player : players)
+            if (result == ActionResult::Success)
             {
-                player.itsSeven();
+                journal->commit();
+            }
+            else
+            {
+                journal->rollback(*this);
             }
-            return;
         }
 
-        // Give the corresponding resources to each player
-        for (auto &player : players)
+        // Ending the turn is recorded by nextPlayer
+        if (record && result == ActionResult::Success && action.type != ActionType::EndTurn)
         {
-            board.giveResources(player, result);
+            record->recordAction(action);
         }
+        return result;
     }
 
     /**
-     * Places a settlement on the game board.
-     *
-     * This function prompts the player to enter a location for the settlement.
-     * If the player has less than 2 settlements, the location is validated and
-     * the settlement is placed on the board. If the player has 2 or more settlements,
-     * the function checks if the player has enough resources to place the settlement.
-     * If the player has enough resources, the location is validated and the settlement
-     * is placed on the board. If the player does not have enough resources, an error
-     * message is printed to the console.
+     * Sets the record that receives the game's moves from now on.
      *
-     * @param player The player placing the settlement
-     * @param board The game board
+     * @param record The record to append to, or nullptr to stop recording.
+     */
+    void Catan::setRecord(GameRecord *record)
+    {
+        this->record = record;
+    }
+
+    /**
+     * Starts keeping the moves of the game in a journal. The board and every player
+     * report their changes to it while a move is being applied.
      *
-     * @throws None
+     * @param journal The journal to keep the moves in, or nullptr to stop.
      */
-    void Catan::placeSettelemnt(Player &player, Board &board)
+    void Catan::setJournal(Journal *journal)
+    {
+        this->journal = journal;
+        board.setJournal(journal);
+        for (auto &player : players)
+        {
+            player.setJournal(journal);
+        }
+        if (journal)
+        {
+            journal->clear();
+        }
+    }
+
+    /**
+     * Passes the Longest Road card to whoever has earned it after a road was built
+     * or cut, and updates the points of the old and the new holder.
+     */
+    void Catan::updateLongestRoad()
+    {
+        setLongestRoadHolder(awardLongestRoad(longestRoadHolder, players.size(), [&](uint8_t player) { return board.getLongestRoad(player); }));
+    }
+
+    void Catan::setLongestRoadHolder(uint8_t holder)
+    {
+        longestRoadHolder = holder;
+        for (size_t i = 0; i < players.size(); i++)
+        {
+            players[i].setLongestRoad(i == holder);
+        }
+    }
+
+    uint8_t Catan::getLongestRoadHolder() const
+    {
+        return longestRoadHolder;
+    }
+
+    bool Catan::undo()
+    {
+        return journal && journal->undo(*this);
+    }
+
+    bool Catan::redo()
+    {
+        return journal && journal->redo(*this);
+    }
+
+    // Checks and executes an action; the rules behind Catan::apply
+    ActionResult Catan::applyAction(const Action &action)
     {
-        int location;
+        Player &player = getCurrentPlayer();
 
-        // Check if the player has less than 2 settlements
-        if (player.getNumOfSettlementsAndCities() < 2)
+        switch (action.type)
         {
-            // Prompt the player to enter a location for the settlement
-            cout << player.getName() << ", enter where you want to place your settlement: ";
-            while (!(cin >> location) || !board.isValidSettlementLocation(location))
+        case ActionType::RollDice:
+            rollDice(board);
+            return ActionResult::Success;
+
+        case ActionType::PlaceSettlement:
+            return placeSettelemnt(player, action.location);
+
+        case ActionType::PlaceRoad:
+            return placeRoad(player, action.location);
+
+        case ActionType::UpgradeSettlement:
+            return upgradeSettlement(player, action.location);
+
+        case ActionType::BuyDevelopmentCard:
+            return buyDevelopmentCard(player);
+
+        case ActionType::PlayYearOfPlenty:
+            return playYearOfPlenty(player, action.resource, action.secondResource);
+
+        case ActionType::PlayMonopoly:
+            return playMonopoly(player, action.resource);
+
+        case ActionType::PlayRoadBuilding:
+            return playRoadBuilding(player, action.location, action.secondLocation);
+
+        case ActionType::TradeResources:
+        case ActionType::SellKnight:
+        case ActionType::BuyKnight:
+        {
+            // Trades need a partner other than the current player
+            if (action.otherPlayer < 0 || (size_t)action.otherPlayer >= players.size() ||
+                (size_t)action.otherPlayer == currentPlayerIndex)
             {
-                cin.clear();
-                cin.ignore(numeric_limits<streamsize>::max(), '\n');
-                cout << "Invalid location. Please enter a valid location for your settlement: ";
+                return ActionResult::InvalidPlayer;
             }
-            if (location < 0 || location > 53)
+            Player &other = players[(size_t)action.otherPlayer];
+
+            if (action.type == ActionType::TradeResources)
             {
-                cout << "Invalid vertex ID." << endl;
-                return;
+                return trade(player, other, action.resource, action.secondResource, action.amount, action.secondAmount);
             }
-            // Place the settlement on the board
-            if (board.placeSettlement(location, player, true))
+            if (action.type == ActionType::SellKnight)
             {
-                player.increaseNumOfSettlements();
-                return;
+                return sellKnight(player, other, action.knights, action.resource, action.amount);
             }
+            return buyKnight(player, other, action.knights, action.resource, action.amount);
         }
-        else
-        {
-            // Check if the player has enough resources to place the settlement
-            if (player.hasEnoughResources("settlement"))
-            {
-                // Prompt the player to enter a location for the settlement
-                cout << player.getName() << ", enter where you want to place your settlement: ";
-                while (!(cin >> location) || !board.isValidSettlementLocation(location))
-                {
-                    cin.clear();
-                    cin.ignore(numeric_limits<streamsize>::max(), '\n');
-                    cout << "Invalid location. Please enter a valid location for your settlement: ";
-                }
-                if (location < 0 || location > 53)
-                {
-                    cout << "Invalid vertex ID." << endl;
-                    return;
-                }
-                // Place the settlement on the board
-                if (board.placeSettlement(location, player, false))
-                {
-                    player.increaseNumOfSettlements();
-                    player.deductResources("settlement");
-                    return;
-                }
-            }
-            else
-            {
-                // Print an error message if the player does not have enough resources
-                cout << "Insufficient resources to place settlement." << endl;
-                return;
-            }
+
+        case ActionType::EndTurn:
+            endTurn();
+            return ActionResult::Success;
         }
+        return ActionResult::InvalidAction;
     }
 
     /**
-     * Upgrades a settlement to a city for the given player.
+     * Rolls the dice and gives the corresponding resources to each player.
+     *
+     * This function rolls the dice by generating a random number between 2 and 12.
+     * The result is stored and can be read back with `getLastRoll`. If the result is 7,
+     * the function calls the `itsSeven` function for each player. Otherwise, the function
+     * gives the corresponding resources to every player by calling the `produce`
+     * function of the `Board` class.
      *
-     * @param player The player upgrading the settlement
      * @param board The game board
      */
-    void Catan::upgradeSettlement(Player &player, Board &board)
+    void Catan::rollDice(Board &board)
     {
-        int location;
-        // Check if the player has enough resources to upgrade the settlement
-        if (player.hasEnoughResources("city"))
+        // Roll two dice, giving a number between 2 and 12
+        int result = rng.rollDie() + rng.rollDie();
+        lastRoll = result;
+        LOG_TRACE(getCurrentPlayer().getName() << " rolled " << result);
+
+        // If the result is 7, call the `itsSeven` function for each player
+        if (result == 7)
         {
-            // Prompt the player to enter a location for the settlement
-            cout << player.getName() << ", enter where you want to upgrade your settlement: ";
-            while (!(cin >> location))
-            {
-                cin.clear();
-                cin.ignore(numeric_limits<streamsize>::max(), '\n');
-                cout << "Invalid location. Please enter a valid location for your city: ";
-            }
-            // Upgrade the settlement to a city
-            if (board.upgradeSettlement(location, player))
+            for (auto &player : players)
             {
-                player.deductResources("city");
-                player.increaseNumOfCities();
-                return;
+                player.itsSeven(rng);
             }
+            return;
         }
-        else
+
+        // Give the corresponding resources to every player at once
+        for (const auto &entry : board.getProduction(result))
         {
-            // Print an error message if the player does not have enough resources
-            cout << "Insufficient resources to upgrade settlement." << endl;
-            return;
+            produced[(size_t)entry.resource] += entry.amount;
         }
+        board.produce(players, result);
     }
 
     /**
-     * Places a road on the game board for the given player.
-     *
-     * This function prompts the player to enter a location for the road.
-     * If the player has enough resources to place the road, the location is validated and
-     * the road is placed on the board. If the player does not have enough resources, an error
-     * message is printed to the console.
+     * Places a settlement on the game board.
      *
-     * @param player The player placing the road
-     * @param board The game board
+     * If the player has less than 2 settlements, the settlement is free and does not
+     * need to be connected to a road. Otherwise, the player must have enough resources
+     * and the location must be connected to one of the player's roads.
      *
-     * @throws None
+     * @param player The player placing the settlement
+     * @param location The vertex ID of the settlement
+     * @return ActionResult::Success if the settlement was placed, otherwise the reason it was not
      */
-    void Catan::placeRoad(Player &player, Board &board)
+    ActionResult Catan::placeSettelemnt(Player &player, int location)
     {
-        int location;
+        // The first two settlements of every player are free
+        bool firstRound = player.getNumOfSettlementsAndCities() < 2;
 
-        // Check if the player has enough resources to place the road
-        if (player.hasEnoughResources("road"))
+        // Check if the player has enough resources to place the settlement
+        if (!firstRound && !player.hasEnoughResources(Purchase::Settlement))
         {
-            // Prompt the player to enter a location for the road
-            cout << player.getName() << ", enter where you want to place your road: ";
+            return ActionResult::InsufficientResources;
+        }
 
-            // Validate the location and place the road on the board
-            while (!(cin >> location) || !board.isValidRoadLocation(location))
-            {
-                cin.clear();
-                cin.ignore(numeric_limits<streamsize>::max(), '\n');
-                cout << "Invalid location. Please enter a valid location for your road: ";
-            }
+        // Validate the location
+        ActionResult result = board.validateSettlement(location, player, firstRound);
+        if (result != ActionResult::Success)
+        {
+            return result;
+        }
 
-            // Check if the edge ID is valid
-            if (location < 0 || location > 71)
-            {
-                cout << "Invalid edge ID." << endl;
-                return;
-            }
+        // Place the settlement on the board
+        board.placeSettlement(location, player, firstRound);
+        player.increaseNumOfSettlements();
+        if (!firstRound)
+        {
+            player.deductResources(Purchase::Settlement);
+        }
 
-            // Continue attempting to place the road until a valid location is chosen
-            while (!board.placeRoad(location, player))
-            {
-                cout << "Invalid location. Please enter a valid location for your road: ";
-                cin >> location;
-            }
+        // The settlement may cut another player's road
+        updateLongestRoad();
+        return ActionResult::Success;
+    }
 
-            // Once a valid location is found, deduct the resources
-            player.deductResources("road");
+    /**
+     * Upgrades a settlement to a city for the given player.
+     *
+     * @param player The player upgrading the settlement
+     * @param location The vertex ID of the settlement
+     * @return ActionResult::Success if the settlement was upgraded, otherwise the reason it was not
+     */
+    ActionResult Catan::upgradeSettlement(Player &player, int location)
+    {
+        // Check if the player has enough resources to upgrade the settlement
+        if (!player.hasEnoughResources(Purchase::City))
+        {
+            return ActionResult::InsufficientResources;
         }
-        else
+
+        // Upgrade the settlement to a city
+        ActionResult result = board.validateUpgrade(location, player);
+        if (result != ActionResult::Success)
         {
-            // Print an error message if the player does not have enough resources
-            cout << "Insufficient resources to place road." << endl;
-            return;
+            return result;
         }
+        board.upgradeSettlement(location, player);
+        player.deductResources(Purchase::City);
+        player.increaseNumOfCities();
+        return ActionResult::Success;
     }
 
     /**
-     * @brief Function to handle trading
+     * Places a road on the game board for the given player.
      *
-     * @param player The player object
-     * @return true if the trade is successful
-     * @return false if the trade is not successful
+     * @param player The player placing the road
+     * @param location The edge ID of the road
+     * @return ActionResult::Success if the road was placed, otherwise the reason it was not
      */
-    bool Catan::trade(Player &player)
+    ActionResult Catan::placeRoad(Player &player, int location)
     {
-        // Variables to store the trading information
-        string name, giveResource, receiveResource;
-        char choice;
-
-        // Prompt for trading a Knight card
-        cout << "Would you like to trade a Knight card? (y/n): ";
-        cin >> choice;
-
-        // If the player wants to trade a Knight card
-        if (choice == 'y')
+        // Check if the player has enough resources to place the road
+        if (!player.hasEnoughResources(Purchase::Road))
         {
-            cout << "Would you like to sell or buy a Knight card? (s/b): ";
-            cin >> choice;
-
-            // If the player does not have any Knight cards
-            if (choice == 's' && player.amountOfKnights() == 0)
-            {
-                cout << "You don't have any Knight cards." << endl;
-                return false;
-            }
-
-            cout << "Enter the name of the player you want to trade with: ";
-            cin >> name;
-
-            // Find the player with the given name
-            Player *other = findPlayerByName(name);
-            if (other == nullptr)
-            {
-                cout << "Player not found." << endl;
-                return false;
-            }
-
-            // Check if the player is trading with themselves
-            if (other->getName() == player.getName())
-            {
-                cout << "You cannot trade with yourself." << endl;
-                return false;
-            }
-
-            // Check if the player exists
-            if (&other == nullptr)
-            {
-                cout << "Player not found." << endl;
-                return false;
-            }
-
-            // If the player wants to sell a Knight card
-            if (choice == 's')
-            {
-                sellKnight(player, *other);
-            }
-            // If the player wants to buy a Knight card
-            else if (choice == 'b')
-            {
-                return buyKnight(player, *other);
-            }
-            else
-            {
-                cout << "Invalid choice." << endl;
-                return false;
-            }
+            return ActionResult::InsufficientResources;
         }
-        // If the player wants to trade resources
-        else
-        {
-            cout << "Enter the name of the player you want to trade with: ";
-            cin >> name;
-
-            // Find the player with the given name
-            Player *other = findPlayerByName(name);
 
-            // Check if the player is trading with themselves
-            if (other->getName() == player.getName())
-            {
-                cout << "You cannot trade with yourself." << endl;
-                return false;
-            }
-
-            // Check if the player exists
-            if (&other == nullptr)
-            {
-                cout << "Player not found." << endl;
-                return false;
-            }
-
-            cout << "Enter the resource you want to give: ";
-            cin >> giveResource;
-            cout << "Enter the resource you want to receive: ";
-            cin >> receiveResource;
-            cout << "Enter the amount you want to give: ";
-            int giveAmount;
-            cin >> giveAmount;
-            cout << "Enter the amount you want to receive: ";
-            int receiveAmount;
-            cin >> receiveAmount;
-
-            // Perform the trade
-            player.trade(*other, giveResource, receiveResource, giveAmount, receiveAmount);
+        // Validate the location and place the road on the board
+        ActionResult result = board.validateRoad(location, player);
+        if (result != ActionResult::Success)
+        {
+            return result;
         }
+        board.placeRoad(location, player);
 
-        return false;
+        // Once the road is placed, deduct the resources
+        player.deductResources(Purchase::Road);
+        updateLongestRoad();
+        return ActionResult::Success;
     }
 
     /**
-     * Buys a development card for the player if they have enough resources.
+     * Trades resources between two players.
      *
-     * @param player The player who is buying the development card.
+     * @param player The player offering the trade
+     * @param other The player accepting the trade
+     * @param giveResource The resource the player gives away
+     * @param receiveResource The resource the player receives
+     * @param giveAmount The amount given away
+     * @param receiveAmount The amount received
+     * @return ActionResult::Success if the trade was completed, otherwise the reason it was not
      */
-    void Catan::buyDevelopmentCard(Player &player)
+    ActionResult Catan::trade(Player &player, Player &other, Resource giveResource, Resource receiveResource, int giveAmount, int receiveAmount)
     {
-        // Check if the player has enough resources to buy a development card.
-        if (player.hasEnoughResources("development card"))
+        // Check if the player is trading with themselves
+        if (&player == &other || other.getId() == player.getId())
         {
-            // Deduct the cost of the development card from the player's resources.
-            player.deductResources("development card");
-
-            // Pick a random number between 1 and 5 to determine which development card to give the player.
-            srand(time(0));
-            int card = rand() % 5 + 1;
-            // If the random number is 1, the player gets a knight card.
-            while (knightsLeft == 0 && card == 1 || VPleft == 0 && card == 5)
-            {
-                card = rand() % 5 + 1;
-            }
-
-            // Determine the type of development card to give the player based on the random number.
-            if (card == 1)
-            {
-                player.addDevelopmentCard("knight");
-                knightsLeft--;
-                cout << "You have bought a knight card." << endl;
-            }
-            else if (card == 2)
-            {
-                player.addDevelopmentCard("year of plenty");
-                cout << "You have bought a year of plenty card." << endl;
-            }
-            else if (card == 3)
-            {
-                player.addDevelopmentCard("monopoly");
-                cout << "You have bought a monopoly card." << endl;
-            }
-            else if (card == 4)
-            {
-                player.addDevelopmentCard("road building");
-                cout << "You have bought a road building card." << endl;
-            }
-            else if (card == 5)
-            {
-                player.addDevelopmentCard("victory point");
-                cout << "You have bought a victory point card." << endl;
-                VPleft--;
-            }
+            return ActionResult::InvalidPlayer;
+        }
 
-            cout << "You have bought a development card." << endl;
+        // Check the resources and amounts being traded
+        if (!isResource(giveResource) || !isResource(receiveResource) || giveResource == receiveResource || giveAmount <= 0 || receiveAmount <= 0)
+        {
+            return ActionResult::InvalidTrade;
         }
-        // If the player does not have enough resources to buy a development card, inform them.
-        else
+
+        // Check if both sides can pay their part
+        if (!player.haveResources(giveResource, giveAmount) || !other.haveResources(receiveResource, receiveAmount))
         {
-            cout << "Insufficient resources to buy development card." << endl;
+            return ActionResult::InsufficientResources;
         }
+
+        // Perform the trade
+        player.trade(other, giveResource, receiveResource, giveAmount, receiveAmount);
+        return ActionResult::Success;
     }
 
     /**
-     * Play a development card for the current player.
+     * Buys a development card for the player if they have enough resources.
      *
-     * Prompts the player to choose a development card from the available
-     * cards and plays the chosen card.
+     * The type of the card that was drawn can be read back with `getLastDevelopmentCard`.
      *
-     * @param player The current player
+     * @param player The player who is buying the development card.
+     * @return ActionResult::Success if a card was bought, ActionResult::InsufficientResources otherwise
      */
-    void Catan::playDevelopmentCard(Player &player)
+    ActionResult Catan::buyDevelopmentCard(Player &player)
     {
-        if (player.getAmountOfDevCards() == 0)
+        // If the player does not have enough resources to buy a development card, reject the purchase.
+        if (!player.hasEnoughResources(Purchase::DevelopmentCard))
         {
-            cout << "You do not have any development cards." << endl;
-            return;
+            return ActionResult::InsufficientResources;
         }
-        int choosenCard;
-        cout << "Which development card do you want to play? (1-3): " << endl;
-        // Display available development cards
-        cout << "1. Year of Plenty" << endl;
-        cout << "2. Monopoly" << endl;
-        cout << "3. Road Building" << endl;
-        cout << "Enter your choice: ";
-        // Validate user input
-        while (!(cin >> choosenCard) || choosenCard < 1 || choosenCard > 3)
+
+        // Deduct the cost of the development card from the player's resources.
+        player.deductResources(Purchase::DevelopmentCard);
+
+        // Collect the card types that can still be drawn: knights and victory points are limited.
+        DevCard available[NUM_DEV_CARDS];
+        size_t count = 0;
+        for (size_t i = 0; i < NUM_DEV_CARDS; i++)
         {
-            cin.clear();
-            cin.ignore(numeric_limits<streamsize>::max(), '\n');
-            cout << "Invalid choice. Please enter a number between 1 and 3: ";
+            DevCard card = (DevCard)i;
+            if ((card == DevCard::Knight && knightsLeft == 0) || (card == DevCard::VictoryPoint && VPleft == 0))
+            {
+                continue;
+            }
+            available[count++] = card;
         }
-        // Play the chosen development card
-        switch (choosenCard)
+
+        // Draw one of them with equal probability.
+        lastDevelopmentCard = available[rng.below((uint32_t)count)];
+        if (lastDevelopmentCard == DevCard::Knight)
+        {
+            knightsLeft--;
+        }
+        else if (lastDevelopmentCard == DevCard::VictoryPoint)
         {
-        case 1:
-            playYearOfPlenty(player);
-            break;
-        case 2:
-            playMonopoly(player);
-            break;
-        case 3:
-            playRoadBuilding(player);
-            break;
+            VPleft--;
         }
+        player.addDevelopmentCard(lastDevelopmentCard);
+        return ActionResult::Success;
     }
 
     /**
      * Sell Knight cards to another player.
      *
-     * Prompts the player to enter the number of Knight cards they want to sell,
-     * the resource they want in return, and the amount of that resource they want
-     * in return. If the other player has enough resources, the cards are sold and
-     * the transaction is completed.
+     * If the other player has enough of the requested resource, the cards are
+     * sold and the transaction is completed.
      *
      * @param player The player selling the Knight cards
      * @param other The player receiving the Knight cards and paying in resources
-     * @return True if the transaction is successful, false otherwise
+     * @param numOfCards The number of Knight cards to sell
+     * @param resource The resource wanted in return
+     * @param amount The amount of that resource wanted in return
+     * @return ActionResult::Success if the transaction is successful, otherwise the reason it failed
      */
-    bool Catan::sellKnight(Player &player, Player &other)
+    ActionResult Catan::sellKnight(Player &player, Player &other, int numOfCards, Resource resource, int amount)
     {
-        cout << "Enter the number of Knight cards you want to sell: ";
-        // Get number of Knight cards to sell
-        int numOfCards;
-        cin >> numOfCards;
-        if (numOfCards > player.amountOfKnights())
+        // Check the number of cards and the price
+        if (!isResource(resource) || numOfCards <= 0 || amount <= 0)
         {
-            cout << "You don't have that many Knight cards." << endl;
-            return false;
+            return ActionResult::InvalidTrade;
         }
-        cout << "What resource do you want in return? ";
-        // Get resource to receive in return
-        string resource;
-        cin >> resource;
-        cout << "How many " << resource << " do you want in return? ";
-        // Get amount of that resource to receive in return
-        int amount;
-        cin >> amount;
-        if (other.haveResources(resource, amount))
-        {
-            // Deduct resources from other player
-            other.deductResources(resource, amount);
-            // Add resources to player
-            player.addResource(resource, amount);
-            // Transfer Knight cards
-            player.addKnights(-numOfCards);
-            other.addKnights(numOfCards);
-            return true;
+        if (numOfCards > player.amountOfKnights())
+        {
+            return ActionResult::NoDevelopmentCard;
         }
-        else
+        if (!other.haveResources(resource, amount))
         {
-            cout << "The other player doesn't have that many " << resource << "." << endl;
-            return false;
+            return ActionResult::InsufficientResources;
         }
+
+        // Deduct resources from other player
+        other.deductResources(resource, amount);
+        // Add resources to player
+        player.addResource(resource, amount);
+        // Transfer Knight cards
+        player.addKnights(-numOfCards);
+        other.addKnights(numOfCards);
+        return ActionResult::Success;
     }
 
     /**
      * Buy Knight cards from another player.
      *
-     * Prompts the player to enter the number of Knight cards they want to buy,
-     * the resource they are willing to pay, and the amount of that resource
-     * they are willing to pay. If the other player has enough resources,
-     * the cards are bought and the transaction is completed.
+     * If the player has enough of the offered resource, the cards are bought
+     * and the transaction is completed.
      *
      * @param player The player buying the Knight cards
      * @param other The player selling the Knight cards and receiving payment
-     * @return True if the transaction is successful, false otherwise
+     * @param numOfCards The number of Knight cards to buy
+     * @param resource The resource paid
+     * @param amount The amount of that resource paid
+     * @return ActionResult::Success if the transaction is successful, otherwise the reason it failed
      */
-    bool Catan::buyKnight(Player &player, Player &other)
+    ActionResult Catan::buyKnight(Player &player, Player &other, int numOfCards, Resource resource, int amount)
     {
-        // Check if the other player has any Knight cards
-        int numOfKnights = other.amountOfKnights();
-        if (numOfKnights == 0)
+        // Check the number of cards and the price
+        if (!isResource(resource) || numOfCards <= 0 || amount <= 0)
         {
-            cout << "The other player doesn't have any Knight cards." << endl;
-            return false;
+            return ActionResult::InvalidTrade;
         }
 
-        // Prompt for the number of Knight cards to buy
-        cout << "Enter the number of Knight cards you want to buy: ";
-        int numOfCards;
-        cin >> numOfCards;
-
         // Check if the other player has enough Knight cards
-        if (numOfCards > numOfKnights)
+        if (numOfCards > other.amountOfKnights())
         {
-            cout << "The other player doesn't have that many Knight cards." << endl;
-            return false;
+            return ActionResult::NoDevelopmentCard;
         }
 
-        // Prompt for the resource to pay and the amount to pay
-        cout << "What resource are you willing to pay? " << endl;
-        string resource;
-        cin >> resource;
-        cout << "How many " << resource << " do you want to pay? ";
-        int amount;
-        cin >> amount;
-
         // Check if the player has enough resources
-        if (player.haveResources(resource, amount))
+        if (!player.haveResources(resource, amount))
         {
-            // Deduct resources from player
-            player.deductResources(resource, amount);
+            return ActionResult::InsufficientResources;
+        }
 
-            // Add resources to other player
-            other.addResource(resource, amount);
+        // Deduct resources from player
+        player.deductResources(resource, amount);
 
-            // Transfer Knight cards
-            player.addKnights(numOfCards);
-            other.addKnights(-numOfCards);
+        // Add resources to other player
+        other.addResource(resource, amount);
 
-            return true;
-        }
-        else
-        {
-            cout << "You don't have that many " << resource << "." << endl;
-            return false;
-        }
+        // Transfer Knight cards
+        player.addKnights(numOfCards);
+        other.addKnights(-numOfCards);
+        return ActionResult::Success;
     }
 
     /**
@@ -705,32 +864,29 @@ namespace ariel
      * Allows the player to gain one of two resources of their choice.
      *
      * @param player The player playing the year of plenty card.
+     * @param resource1 The first resource to take.
+     * @param resource2 The second resource to take.
+     * @return ActionResult::Success if the card was played, otherwise the reason it was not
      */
-    void Catan::playYearOfPlenty(Player &player)
+    ActionResult Catan::playYearOfPlenty(Player &player, Resource resource1, Resource resource2)
     {
-        // Check if the player has enough resources to play the card
-        if (player.hasEnoughResources("year of plenty"))
+        // Check that both resources exist
+        if (!isResource(resource1) || !isResource(resource2))
         {
-            // Prompt the player for the two resources they want
-            string resource1, resource2;
-            cout << "Enter the first resource: ";
-            cin >> resource1;
-            cout << "Enter the second resource: ";
-            cin >> resource2;
-
-            // Give the player one of each resource
-            player.addResource(resource1, 1);
-            player.addResource(resource2, 1);
-
-            // Deduct the resources used to play the card
-            player.deductResources("year of plenty");
+            return ActionResult::InvalidTrade;
         }
-        else
+        // Check if the player has the card
+        if (!player.hasDevelopmentCard(DevCard::YearOfPlenty))
         {
-            // Notify the player that they don't have enough resources
-            cout << "Insufficient resources to play year of plenty." << endl;
-            return;
+            return ActionResult::NoDevelopmentCard;
         }
+        // Give the player one of each resource
+        player.addResource(resource1, 1);
+        player.addResource(resource2, 1);
+
+        // Deduct the card
+        player.removeDevelopmentCard(DevCard::YearOfPlenty);
+        return ActionResult::Success;
     }
 
     /**
@@ -740,68 +896,108 @@ namespace ariel
      * other players.
      *
      * @param player The player playing the monopoly card.
+     * @param resource The resource to take.
+     * @return ActionResult::Success if the card was played, otherwise the reason it was not
      */
-    void Catan::playMonopoly(Player &player)
+    ActionResult Catan::playMonopoly(Player &player, Resource resource)
     {
-        // Check if the player has enough resources to play the card
-        if (player.hasEnoughResources("monopoly"))
+        // Check that the resource exists
+        if (!isResource(resource))
         {
-            // Prompt the player for the resource they want
-            string resource;
-            cout << "Enter the resource: ";
-            cin >> resource;
-
-            // Take all resources of the specified type from all other players
-            for (auto &other : players)
+            return ActionResult::InvalidTrade;
+        }
+        // Check if the player has the card
+        if (!player.hasDevelopmentCard(DevCard::Monopoly))
+        {
+            return ActionResult::NoDevelopmentCard;
+        }
+        // Take all resources of the specified type from all other players
+        for (auto &other : players)
+        {
+            if (other.getId() != player.getId())
             {
-                if (other.getName() != player.getName())
-                {
-                    // Calculate the amount of the specified resource held by the other player
-                    int amount = other.amountOfResources(resource);
+                // Calculate the amount of the specified resource held by the other player
+                int amount = other.amountOfResources(resource);
 
-                    // Give the player the specified amount of resources
-                    player.addResource(resource, amount);
+                // Give the player the specified amount of resources
+                player.addResource(resource, amount);
 
-                    // Take the specified amount of resources from the other player
-                    other.deductResources(resource, amount);
-
-                    // Notify the player that they got the specified amount of resources
-                    cout << "You got " << amount << " " << resource << " from " << other.getName() << "." << endl;
-                }
+                // Take the specified amount of resources from the other player
+                other.deductResources(resource, amount);
             }
-            // Deduct the resources used to play the card
-            player.deductResources("monopoly");
+        }
+        // Deduct the card
+        player.removeDevelopmentCard(DevCard::Monopoly);
+        return ActionResult::Success;
+    }
 
-            cout << "Resources taken successfully." << endl;
+    /**
+     * Checks if an edge is free and touches another edge at a vertex without another
+     * player's building, so a road on it would extend a road that is about to be built
+     * on the other edge.
+     *
+     * @param edgeId The edge to check
+     * @param extendedEdgeId The edge that is being extended
+     * @param player The player building the roads
+     * @return True if the edge extends the other edge or is otherwise a valid road location
+     */
+    bool Catan::isRoadExtendingEdge(int edgeId, int extendedEdgeId, Player &player)
+    {
+        if (edgeId == extendedEdgeId || !board.isValidRoadLocation(edgeId))
+        {
+            return false;
         }
-        else
+        if (board.validateRoad(edgeId, player) == ActionResult::Success)
         {
-            // Notify the player that they don't have enough resources
-            cout << "Insufficient resources to play monopoly." << endl;
-            return;
+            return true;
         }
+        return board.extendsRoad(edgeId, extendedEdgeId, player.getId());
     }
 
     /**
-     * Plays the road building card and gives the player 2 brick and 2 lumber resources.
-     * Then, it places two roads on the board.
+     * Plays the road building card, which places two roads on the board for free.
+     * The second road may extend the first one.
      *
      * @param player The player playing the road building card.
+     * @param firstEdge The edge ID of the first road.
+     * @param secondEdge The edge ID of the second road.
+     * @return ActionResult::Success if both roads were placed, otherwise the reason they were not
      */
-    void Catan::playRoadBuilding(Player &player)
+    ActionResult Catan::playRoadBuilding(Player &player, int firstEdge, int secondEdge)
     {
-        // Give the player 2 brick and 2 lumber resources
-        player.addResource("brick", 2);
-        player.addResource("lumber", 2);
+        // Check if the player has the card
+        if (!player.hasDevelopmentCard(DevCard::RoadBuilding))
+        {
+            return ActionResult::NoDevelopmentCard;
+        }
 
-        // Place two roads on the board
-        placeRoad(player, board);
-        placeRoad(player, board);
+        // Validate both roads before placing anything
+        ActionResult result = board.validateRoad(firstEdge, player);
+        if (result != ActionResult::Success)
+        {
+            return result;
+        }
+        if (secondEdge == firstEdge)
+        {
+            return ActionResult::LocationOccupied;
+        }
+        if (board.getRoadsLeft(player.getId()) < 2)
+        {
+            return ActionResult::NoRoadsLeft;
+        }
+        if (!isRoadExtendingEdge(secondEdge, firstEdge, player))
+        {
+            return board.isValidRoadLocation(secondEdge) ? ActionResult::NotConnected : ActionResult::InvalidLocation;
+        }
 
-        // Deduct the resources used to play the card
-        player.deductResources("road building");
+        // Place two roads on the board
+        board.placeRoadAtEdge(board.getEdge(firstEdge), player);
+        board.placeRoadAtEdge(board.getEdge(secondEdge), player);
 
-        cout << "Roads placed successfully." << endl;
+        // Deduct the card
+        player.removeDevelopmentCard(DevCard::RoadBuilding);
+        updateLongestRoad();
+        return ActionResult::Success;
     }
 
-}
\ No newline at end of file
+}
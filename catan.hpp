@@ -5,29 +5,84 @@
 #include <string>
 #include <vector>
 #include <algorithm>
-#include <random>
-#include <cstdlib> // For srand() and rand()
-#include <ctime>   // For time()
+#include <cstdint>
 
 #include "player.hpp"
 #include "board.hpp"
+#include "action.hpp"
+#include "rng.hpp"
 
 using namespace std;
 
 namespace ariel
 {
 
+    class GameRecord;
+    class Journal;
+    class Catan;
+
+    // Seats a game can have. Seat indices are stored as bytes, with NO_PLAYER kept free.
+    const size_t MIN_PLAYERS = 2;
+    const size_t MAX_PLAYERS = NO_PLAYER;
+
+    // The order of the setup rounds for any number of players: every seat places once in
+    // seat order, then once in reverse order, so the last seat places twice in a row
+    // and seat 0 places last and then starts the game
+    class SetupSchedule
+    {
+    private:
+        size_t numOfPlayers;
+
+    public:
+        explicit SetupSchedule(size_t numOfPlayers) : numOfPlayers(numOfPlayers) {}
+
+        // Number of placements in the setup rounds
+        size_t size() const { return 2 * numOfPlayers; }
+
+        // Seat that places at a step
+        size_t seat(size_t step) const { return step < numOfPlayers ? step : 2 * numOfPlayers - 1 - step; }
+
+        // Moves the game from the seat of a step to the seat of the next one
+        void advance(Catan &game, size_t step) const;
+    };
+
     class Catan
     {
+        friend class GameState;
+        friend class Journal;
+
     private:
+        uint64_t seed;
+        Rng rng; // Declared before the board, which is shuffled with it
         Board board;
         vector<Player> players;
+        vector<string> playerNames;
         size_t currentPlayerIndex;
+        uint8_t longestRoadHolder; // Seat holding the Longest Road card, or NO_PLAYER
         int knightsLeft;
         int VPleft;
+        int lastRoll;
+        DevCard lastDevelopmentCard;
+        array<int, NUM_RESOURCES> produced; // Resources handed out by dice rolls, per type
+        GameRecord *record;                 // Receives every applied move, if set
+        Journal *journal;                   // Keeps every applied move for undo, if set
+
+        ActionResult applyAction(const Action &action);
+        void updateLongestRoad();
+        void setLongestRoadHolder(uint8_t holder);
+
+        bool isRoadExtendingEdge(int edgeId, int extendedEdgeId, Player &player);
+        void assignPlayerIds();
 
     public:
         Catan(Player &p1, Player &p2, Player &p3);
+        Catan(Player &p1, Player &p2, Player &p3, uint64_t seed);
+
+        // A game for MIN_PLAYERS to MAX_PLAYERS players, seated in the given order
+        explicit Catan(const vector<Player> &players);
+        Catan(const vector<Player> &players, uint64_t seed);
+        uint64_t getSeed() const;
+        Rng &getRng();
         void ChooseStartingPlayer();
         void nextPlayer();
         void previousPlayer();
@@ -36,19 +91,48 @@ namespace ariel
         void rollDice(Board &board);
         void endTurn();
         Player &getCurrentPlayer();
+        Player &getPlayer(size_t index);
+        size_t getNumOfPlayers() const;
+        const vector<string> &getPlayerNames() const;
+        int getLastRoll() const;
+        DevCard getLastDevelopmentCard() const;
+        const array<int, NUM_RESOURCES> &getProducedResources() const;
+
+        // Seat of the player holding the Longest Road card, or NO_PLAYER
+        uint8_t getLongestRoadHolder() const;
+
+        // Zobrist hash of the position: buildings, roads, hands, development cards, the
+        // cards left in the bank, the Longest Road holder and the player to move. The board and the players keep
+        // their parts up to date, so this costs a few XORs.
+        uint64_t getHash() const;
         bool isGameEnded();
         Player *findPlayerByName(string name);
-        void placeSettelemnt(Player &palyer, Board &board);
-        void upgradeSettlement(Player &player, Board &board);
-        void placeRoad(Player &player, Board &board);
-        void playDevelopmentCard(Player &player);
-        bool trade(Player &player);
-        void buyDevelopmentCard(Player &player);
-        bool sellKnight(Player &player, Player &otherPlayer);
-        bool buyKnight(Player &player, Player &otherPlayer);
-        void playYearOfPlenty(Player &player);
-        void playMonopoly(Player &player);
-        void playRoadBuilding(Player &player);
+        int findPlayerIndexByName(const string &name) const;
+
+        // Applies an action for the current player without any stream I/O
+        ActionResult apply(const Action &action);
+
+        // Appends every successful action and change of seat to the record; null stops recording
+        void setRecord(GameRecord *record);
+
+        // Keeps every successful action and change of seat in the journal, starting an empty
+        // history; null stops it. Undoing a move also takes it out of an attached record.
+        void setJournal(Journal *journal);
+
+        // Take back the last move, or apply the last undone move again; false if there is none
+        bool undo();
+        bool redo();
+
+        ActionResult placeSettelemnt(Player &player, int location);
+        ActionResult upgradeSettlement(Player &player, int location);
+        ActionResult placeRoad(Player &player, int location);
+        ActionResult trade(Player &player, Player &other, Resource giveResource, Resource receiveResource, int giveAmount, int receiveAmount);
+        ActionResult buyDevelopmentCard(Player &player);
+        ActionResult sellKnight(Player &player, Player &otherPlayer, int numOfCards, Resource resource, int amount);
+        ActionResult buyKnight(Player &player, Player &otherPlayer, int numOfCards, Resource resource, int amount);
+        ActionResult playYearOfPlenty(Player &player, Resource resource1, Resource resource2);
+        ActionResult playMonopoly(Player &player, Resource resource);
+        ActionResult playRoadBuilding(Player &player, int firstEdge, int secondEdge);
     };
 }
 
@@ -0,0 +1,233 @@
+#include "evaluator.hpp"
+
+#include <cmath>
+
+namespace ariel
+{
+
+    static inline float lane(const Float4 *row, size_t index)
+    {
+        return row[index / 4][index % 4];
+    }
+
+    static inline Float4 splat(float value)
+    {
+        Float4 result = {value, value, value, value};
+        return result;
+    }
+
+    /**
+     * Gathers the pips of every resource at every vertex from the tiles around it, and
+     * the scarcity of each resource: the average pips per resource over its own pips,
+     * so a resource with half the average production counts double.
+     *
+     * @param board The board whose tiles are scored.
+     * @param weights How much each term adds to the value of a vertex.
+     */
+    VertexEvaluator::VertexEvaluator(Board &board, const EvaluatorWeights &weights) : weights(weights)
+    {
+        float raw[NUM_RESOURCES][LANES] = {};
+        float diversity[LANES] = {};
+        float boardPips[NUM_RESOURCES] = {};
+        for (int v = 0; v < NUM_VERTICES; v++)
+        {
+            for (int tileIndex : board.getVertexTiles(v))
+            {
+                const Tile &tile = board.getTile(tileIndex);
+                if (!tile.desert)
+                {
+                    size_t r = (size_t)tile.resource;
+                    float tilePips = (float)(6 - abs(7 - tile.number));
+                    diversity[v] += raw[r][v] == 0.0f ? 1.0f : 0.0f;
+                    raw[r][v] += tilePips;
+                    boardPips[r] += tilePips;
+                }
+            }
+        }
+
+        float average = 0.0f;
+        for (size_t r = 0; r < NUM_RESOURCES; r++)
+        {
+            average += boardPips[r] / (float)NUM_RESOURCES;
+        }
+        for (size_t r = 0; r < NUM_RESOURCES; r++)
+        {
+            scarcity[r] = boardPips[r] > 0.0f ? average / boardPips[r] : 0.0f;
+        }
+
+        for (size_t i = 0; i < VECTORS; i++)
+        {
+            Float4 total = splat(0.0f);
+            Float4 scarce = splat(0.0f);
+            for (size_t r = 0; r < NUM_RESOURCES; r++)
+            {
+                Float4 row = {raw[r][4 * i], raw[r][4 * i + 1], raw[r][4 * i + 2], raw[r][4 * i + 3]};
+                pips[r][i] = row;
+                total += row;
+                scarce += row * scarcity[r];
+            }
+            Float4 distinct = {diversity[4 * i], diversity[4 * i + 1], diversity[4 * i + 2], diversity[4 * i + 3]};
+            scarcePips[i] = scarce;
+            scores[i] = total * weights.pips + distinct * weights.diversity + scarce * weights.scarcity;
+        }
+    }
+
+    float VertexEvaluator::score(int vertexId) const
+    {
+        return lane(scores, (size_t)vertexId);
+    }
+
+    // For every vertex, the scarcity-scaled pips that it and the owned vertex produce
+    // of a resource the other one lacks; the bonus is the same in both directions
+    void VertexEvaluator::addComplement(int owned, Float4 *row) const
+    {
+        const Float4 zero = splat(0.0f);
+        for (size_t r = 0; r < NUM_RESOURCES; r++)
+        {
+            float factor = scarcity[r] * weights.complement;
+            float ownedPips = lane(pips[r], (size_t)owned);
+            if (ownedPips == 0.0f)
+            {
+                for (size_t i = 0; i < VECTORS; i++)
+                {
+                    row[i] += pips[r][i] * factor;
+                }
+            }
+            else
+            {
+                Float4 bonus = splat(ownedPips * factor);
+                for (size_t i = 0; i < VECTORS; i++)
+                {
+                    row[i] += pips[r][i] == zero ? bonus : zero;
+                }
+            }
+        }
+    }
+
+    float VertexEvaluator::pairScore(int first, int second) const
+    {
+        Float4 row[VECTORS] = {};
+        addComplement(first, row);
+        return score(first) + score(second) + lane(row, (size_t)second);
+    }
+
+    void VertexEvaluator::maskRow(const VertexMask &legal, Float4 *row)
+    {
+        for (size_t v = 0; v < LANES; v++)
+        {
+            if (v >= (size_t)NUM_VERTICES || !legal.test((int)v))
+            {
+                row[v / 4][v % 4] = -INFINITY;
+            }
+        }
+    }
+
+    float VertexEvaluator::rowMax(const Float4 *row)
+    {
+        Float4 best = row[0];
+        for (size_t i = 1; i < VECTORS; i++)
+        {
+            best = best > row[i] ? best : row[i];
+        }
+        return fmax(fmax(best[0], best[1]), fmax(best[2], best[3]));
+    }
+
+    int VertexEvaluator::argmax(const Float4 *row)
+    {
+        float top = rowMax(row);
+        if (top == -INFINITY)
+        {
+            return -1;
+        }
+        for (size_t v = 0; v < LANES; v++)
+        {
+            if (lane(row, v) == top)
+            {
+                return (int)v;
+            }
+        }
+        return -1;
+    }
+
+    int VertexEvaluator::bestVertex(const VertexMask &legal) const
+    {
+        Float4 row[VECTORS];
+        for (size_t i = 0; i < VECTORS; i++)
+        {
+            row[i] = scores[i];
+        }
+        maskRow(legal, row);
+        return argmax(row);
+    }
+
+    int VertexEvaluator::bestPartner(int owned, const VertexMask &legal) const
+    {
+        Float4 row[VECTORS];
+        for (size_t i = 0; i < VECTORS; i++)
+        {
+            row[i] = scores[i];
+        }
+        addComplement(owned, row);
+        maskRow(legal, row);
+        return argmax(row);
+    }
+
+    /**
+     * Tries every legal first vertex against all second vertices at once: the row of
+     * partner values is the scores plus the complement towards the first vertex, with
+     * the first vertex, its neighbors and the illegal vertices masked out. The complement
+     * of a pair is at most the complement weight times the scarce pips of both vertices,
+     * which bounds the best partner of any vertex, so most first vertices are skipped.
+     * The bound only holds while no weight is negative; otherwise every first vertex
+     * is tried.
+     */
+    pair<int, int> VertexEvaluator::bestPair(const VertexMask &legal) const
+    {
+        Float4 masked[VECTORS];
+        for (size_t i = 0; i < VECTORS; i++)
+        {
+            masked[i] = scores[i];
+        }
+        maskRow(legal, masked);
+
+        Float4 reach[VECTORS];
+        Float4 complement = splat(weights.complement);
+        for (size_t i = 0; i < VECTORS; i++)
+        {
+            reach[i] = masked[i] + scarcePips[i] * complement;
+        }
+        float bestReach = rowMax(reach);
+        bool prune = weights.pips >= 0.0f && weights.diversity >= 0.0f &&
+                     weights.scarcity >= 0.0f && weights.complement >= 0.0f;
+
+        pair<int, int> best(-1, -1);
+        float bestValue = -INFINITY;
+        legal.forEach([&](int first) {
+            if (first >= NUM_VERTICES ||
+                (prune && score(first) + lane(scarcePips, (size_t)first) * weights.complement + bestReach <= bestValue))
+            {
+                return;
+            }
+            Float4 row[VECTORS];
+            for (size_t i = 0; i < VECTORS; i++)
+            {
+                row[i] = masked[i];
+            }
+            addComplement(first, row);
+            row[(size_t)first / 4][(size_t)first % 4] = -INFINITY;
+            for (int neighbor : standardTopology().vertexVertices[first])
+            {
+                row[(size_t)neighbor / 4][(size_t)neighbor % 4] = -INFINITY;
+            }
+            // Only an improvement needs to know which vertex gave it
+            float value = score(first) + rowMax(row);
+            if (value > bestValue)
+            {
+                int second = argmax(row);
+                bestValue = value;
+                best = score(first) >= score(second) ? make_pair(first, second) : make_pair(second, first);
+            }
+        });
+        return best;
+    }
+}
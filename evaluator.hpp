@@ -0,0 +1,79 @@
+#ifndef EVALUATOR_HPP
+#define EVALUATOR_HPP
+
+#include <cstddef>
+#include <utility>
+
+#include "board.hpp"
+
+using namespace std;
+
+namespace ariel
+{
+
+    // Four floats handled by one SIMD instruction (SSE on x86, NEON on ARM)
+    typedef float Float4 __attribute__((vector_size(16)));
+
+    // How much each term adds to the value of a vertex
+    struct EvaluatorWeights
+    {
+        float pips;       // Per pip of production, whatever the resource
+        float diversity;  // Per distinct resource produced
+        float scarcity;   // Per pip, scaled by how rare the resource is on the board
+        float complement; // Per scarcity-scaled pip one vertex of a pair adds that the other lacks
+
+        EvaluatorWeights() : pips(1.0f), diversity(1.0f), scarcity(0.5f), complement(0.5f) {}
+    };
+
+    // Scores every vertex of a board for placement. The tiles never move, so the
+    // per-vertex inputs are gathered once into a structure of arrays, one row of
+    // floats per input with a lane per vertex; scoring and pair search then run four
+    // vertices per instruction and are cheap enough to call inside a tree search.
+    class VertexEvaluator
+    {
+    public:
+        // Vertices rounded up to whole vectors; the padding lanes are never legal
+        static const size_t LANES = (NUM_VERTICES + 3) / 4 * 4;
+        static const size_t VECTORS = LANES / 4;
+
+        explicit VertexEvaluator(Board &board, const EvaluatorWeights &weights = EvaluatorWeights());
+
+        // Value of a vertex on its own
+        float score(int vertexId) const;
+
+        // Value of owning two vertices: both scores plus what each adds to the other
+        float pairScore(int first, int second) const;
+
+        // The legal vertex with the highest score, or -1 if none is legal
+        int bestVertex(const VertexMask &legal) const;
+
+        // The legal vertex that goes best with one the player already owns, or -1
+        int bestPartner(int owned, const VertexMask &legal) const;
+
+        // The best two legal vertices that are not neighbors, higher score first, for a
+        // player placing both setup settlements; {-1, -1} if no such pair exists
+        pair<int, int> bestPair(const VertexMask &legal) const;
+
+    private:
+        EvaluatorWeights weights;
+        float scarcity[NUM_RESOURCES]; // Average pips per resource over the resource's pips
+
+        Float4 pips[NUM_RESOURCES][VECTORS]; // Pips of each resource at each vertex
+        Float4 scarcePips[VECTORS];          // Pips scaled by scarcity, summed over resources
+        Float4 scores[VECTORS];              // Weighted value of each vertex
+
+        // Adds the complement bonus of every vertex paired with a given one to a row of values
+        void addComplement(int owned, Float4 *row) const;
+
+        // Illegal lanes of a row become minus infinity
+        static void maskRow(const VertexMask &legal, Float4 *row);
+
+        // Largest value of a row
+        static float rowMax(const Float4 *row);
+
+        // Lowest lane holding the largest value, or -1 if every lane is minus infinity
+        static int argmax(const Float4 *row);
+    };
+}
+
+#endif
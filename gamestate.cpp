@@ -0,0 +1,805 @@
+#include "gamestate.hpp"
+#include "longestroad.hpp"
+
+namespace ariel
+{
+
+    int PlayerState::totalResources() const
+    {
+        int sum = 0;
+        for (int amount : resources)
+        {
+            sum += amount;
+        }
+        return sum;
+    }
+
+    /**
+     * Counts the points of the player, like Player::getPoints: one per settlement,
+     * two per city, two for holding three knights, two for the Longest Road and one
+     * per victory point card.
+     */
+    int PlayerState::points() const
+    {
+        int sum = numOfSettlements + 2 * numOfCities;
+        if (devCards[(size_t)DevCard::Knight] >= 3)
+        {
+            sum += 2;
+        }
+        if (longestRoad)
+        {
+            sum += 2;
+        }
+        return sum + devCards[(size_t)DevCard::VictoryPoint];
+    }
+
+    bool PlayerState::canAfford(Purchase purchase) const
+    {
+        const int *cost = purchaseCost(purchase);
+        for (size_t r = 0; r < NUM_RESOURCES; r++)
+        {
+            if (resources[r] < cost[r])
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void PlayerState::pay(Purchase purchase)
+    {
+        const int *cost = purchaseCost(purchase);
+        for (size_t r = 0; r < NUM_RESOURCES; r++)
+        {
+            resources[r] = (int16_t)(resources[r] - cost[r]);
+        }
+    }
+
+    // Zeroes the whole state, padding included, so states can be compared bitwise
+    void GameState::clear()
+    {
+        memset((void *)this, 0, sizeof(GameState));
+    }
+
+    /**
+     * Takes a snapshot of a game.
+     *
+     * @param game The game to copy; it must have at most MAX_PLAYERS players.
+     */
+    GameState::GameState(Catan &game)
+    {
+        if (game.players.size() > MAX_PLAYERS)
+        {
+            throw invalid_argument("Too many players for a GameState");
+        }
+        clear();
+
+        rng = game.rng;
+        seed = game.seed;
+        numOfPlayers = (uint8_t)game.players.size();
+        currentPlayer = (uint8_t)game.currentPlayerIndex;
+        longestRoadHolder = game.longestRoadHolder;
+        knightsLeft = (int8_t)game.knightsLeft;
+        VPleft = (int8_t)game.VPleft;
+        lastRoll = (int8_t)game.lastRoll;
+        lastDevelopmentCard = game.lastDevelopmentCard;
+        for (size_t r = 0; r < NUM_RESOURCES; r++)
+        {
+            produced[r] = game.produced[r];
+        }
+
+        Board &board = game.board;
+        for (int i = 0; i < NUM_TILES; i++)
+        {
+            const Tile &tile = board.getTile(i);
+            tileResources[(size_t)i] = tile.desert ? (uint8_t)NUM_RESOURCES : (uint8_t)tile.resource;
+            tileNumbers[(size_t)i] = (uint8_t)tile.number;
+        }
+        buildings = board.getBuildingsMask();
+        roads = board.getRoadsMask();
+        openVertices = board.getLegalSettlements(0, true);
+
+        for (size_t i = 0; i < numOfPlayers; i++)
+        {
+            const Player &source = game.players[i];
+            PlayerState &player = players[i];
+            for (size_t r = 0; r < NUM_RESOURCES; r++)
+            {
+                player.resources[r] = (int16_t)source.resources[r];
+            }
+            for (size_t c = 0; c < NUM_DEV_CARDS; c++)
+            {
+                player.devCards[c] = (int16_t)source.devCards[c];
+            }
+            player.numOfSettlements = (uint8_t)source.numOfSettlements;
+            player.numOfCities = (uint8_t)source.numOfCities;
+            player.roadLength = (uint8_t)board.getLongestRoad((uint8_t)i);
+            player.longestRoad = source.hasLongestRoad() ? 1 : 0;
+            player.settlements = board.getSettlementsMask((uint8_t)i);
+            player.cities = board.getCitiesMask((uint8_t)i);
+            player.roads = board.getRoadsMask((uint8_t)i);
+            player.legalSettlements = board.getLegalSettlements((uint8_t)i, false);
+            // The stored mask, which getLegalRoads hides once the player is out of roads
+            if (i < board.legalRoadMasks.size())
+            {
+                player.legalRoads = board.legalRoadMasks[i];
+            }
+        }
+    }
+
+    /**
+     * Writes the state back into a game. The tiles, pieces, hands, counters and
+     * random number generator are replaced; the player names are kept. The jump
+     * is not a move, so an attached journal starts over and an attached record
+     * is detached, as neither could take the game back to where it was.
+     *
+     * @param game The game to overwrite; it must have the same number of players.
+     */
+    void GameState::restore(Catan &game) const
+    {
+        if (game.players.size() != numOfPlayers)
+        {
+            throw invalid_argument("GameState has a different number of players");
+        }
+
+        // Rebuild without the journal, which would otherwise see the placements below
+        Journal *journal = game.journal;
+        game.setJournal(nullptr);
+        game.setRecord(nullptr);
+
+        game.rng = rng;
+        game.seed = seed;
+        game.currentPlayerIndex = currentPlayer;
+        game.knightsLeft = knightsLeft;
+        game.VPleft = VPleft;
+        game.lastRoll = lastRoll;
+        game.lastDevelopmentCard = lastDevelopmentCard;
+        for (size_t r = 0; r < NUM_RESOURCES; r++)
+        {
+            game.produced[r] = produced[r];
+        }
+
+        for (size_t i = 0; i < numOfPlayers; i++)
+        {
+            Player &target = game.players[i];
+            const PlayerState &player = players[i];
+            target.sumeOfResources = player.totalResources();
+            for (size_t r = 0; r < NUM_RESOURCES; r++)
+            {
+                target.resources[r] = player.resources[r];
+            }
+            for (size_t c = 0; c < NUM_DEV_CARDS; c++)
+            {
+                target.devCards[c] = player.devCards[c];
+            }
+            target.numOfSettlements = player.numOfSettlements;
+            target.numOfCities = player.numOfCities;
+            target.rehash();
+        }
+
+        // Rebuild the board: tiles first, then every piece through the usual placement code
+        Board &board = game.board;
+        for (int i = 0; i < NUM_TILES; i++)
+        {
+            uint8_t resource = tileResources[(size_t)i];
+            board.getTile(i) = resource == NUM_RESOURCES ? Tile("Desert", 7) : Tile(resourceName((Resource)resource), tileNumbers[(size_t)i]);
+        }
+        board.clearPieces();
+        for (size_t i = 0; i < numOfPlayers; i++)
+        {
+            Player &owner = game.players[i];
+            const PlayerState &player = players[i];
+            (player.settlements | player.cities).forEach([&](int v) { board.placeSettlementAtVertex(board.getVertex(v), owner); });
+            player.cities.forEach([&](int v) { board.upgradeSettlement(v, owner); });
+            player.roads.forEach([&](int e) { board.placeRoadAtEdge(board.getEdge(e), owner); });
+        }
+        game.setLongestRoadHolder(longestRoadHolder);
+        game.setJournal(journal);
+    }
+
+    /**
+     * Applies a single action on behalf of the current player. The checks, their
+     * order, the results and the random draws are the same as in Catan::apply.
+     *
+     * @param action The action to apply
+     * @return ActionResult::Success if the action was applied, otherwise the reason it was rejected
+     */
+    ActionResult GameState::apply(const Action &action)
+    {
+        uint8_t player = currentPlayer;
+
+        switch (action.type)
+        {
+        case ActionType::RollDice:
+            applyRoll(rng.rollDie() + rng.rollDie());
+            return ActionResult::Success;
+
+        case ActionType::PlaceSettlement:
+            return placeSettlement(player, action.location);
+
+        case ActionType::PlaceRoad:
+            return placeRoad(player, action.location);
+
+        case ActionType::UpgradeSettlement:
+            return upgradeSettlement(player, action.location);
+
+        case ActionType::BuyDevelopmentCard:
+            return buyDevelopmentCard(player);
+
+        case ActionType::PlayYearOfPlenty:
+            return playYearOfPlenty(player, action.resource, action.secondResource);
+
+        case ActionType::PlayMonopoly:
+            return playMonopoly(player, action.resource);
+
+        case ActionType::PlayRoadBuilding:
+            return playRoadBuilding(player, action.location, action.secondLocation);
+
+        case ActionType::TradeResources:
+        case ActionType::SellKnight:
+        case ActionType::BuyKnight:
+        {
+            // Trades need a partner other than the current player
+            if (action.otherPlayer < 0 || action.otherPlayer >= numOfPlayers || action.otherPlayer == player)
+            {
+                return ActionResult::InvalidPlayer;
+            }
+            uint8_t other = (uint8_t)action.otherPlayer;
+
+            if (action.type == ActionType::TradeResources)
+            {
+                return trade(player, other, action.resource, action.secondResource, action.amount, action.secondAmount);
+            }
+            if (action.type == ActionType::SellKnight)
+            {
+                return sellKnight(player, other, action.knights, action.resource, action.amount);
+            }
+            // Buying knights is the partner selling them
+            return sellKnight(other, player, action.knights, action.resource, action.amount);
+        }
+
+        case ActionType::EndTurn:
+            currentPlayer = (uint8_t)((currentPlayer + 1) % numOfPlayers);
+            return ActionResult::Success;
+        }
+        return ActionResult::InvalidAction;
+    }
+
+    /**
+     * Lists the actions a search should consider for the current player.
+     *
+     * Every affordable build and card purchase is listed, as are all plays of the
+     * cards the player holds. Trades are limited to one knight for one resource,
+     * since the engine lets any trade through and larger ones add little.
+     *
+     * @param actions Cleared and filled with the actions; ending the turn is always first.
+     */
+    void GameState::legalActions(vector<Action> &actions) const
+    {
+        const PlayerState &player = players[currentPlayer];
+        actions.clear();
+        actions.push_back(Action::endTurn());
+
+        if (player.canAfford(Purchase::City))
+        {
+            player.settlements.forEach([&](int v) { actions.push_back(Action::upgradeSettlement(v)); });
+        }
+        if (player.canAfford(Purchase::Settlement) && player.numOfSettlements + player.numOfCities >= 2)
+        {
+            player.legalSettlements.forEach([&](int v) { actions.push_back(Action::placeSettlement(v)); });
+        }
+        if (player.canAfford(Purchase::Road))
+        {
+            getLegalRoads(currentPlayer).forEach([&](int e) { actions.push_back(Action::placeRoad(e)); });
+        }
+        if (player.canAfford(Purchase::DevelopmentCard))
+        {
+            actions.push_back(Action::buyDevelopmentCard());
+        }
+
+        if (player.devCards[(size_t)DevCard::YearOfPlenty] > 0)
+        {
+            for (size_t first = 0; first < NUM_RESOURCES; first++)
+            {
+                for (size_t second = first; second < NUM_RESOURCES; second++)
+                {
+                    actions.push_back(Action::playYearOfPlenty((Resource)first, (Resource)second));
+                }
+            }
+        }
+        if (player.devCards[(size_t)DevCard::Monopoly] > 0)
+        {
+            for (size_t r = 0; r < NUM_RESOURCES; r++)
+            {
+                actions.push_back(Action::playMonopoly((Resource)r));
+            }
+        }
+        if (player.devCards[(size_t)DevCard::RoadBuilding] > 0 && player.roadsLeft() >= 2)
+        {
+            // The second road is any legal road or one extending the first; each pair is listed once
+            player.legalRoads.forEach([&](int first) {
+                (player.legalRoads | roadExtensions(currentPlayer, first)).without(roads).forEach([&](int second) {
+                    if (second != first && (second > first || !player.legalRoads.test(second)))
+                    {
+                        actions.push_back(Action::playRoadBuilding(first, second));
+                    }
+                });
+            });
+        }
+
+        for (int other = 0; other < numOfPlayers; other++)
+        {
+            if (other == currentPlayer)
+            {
+                continue;
+            }
+            const PlayerState &partner = players[(size_t)other];
+            for (size_t r = 0; r < NUM_RESOURCES; r++)
+            {
+                if (player.devCards[(size_t)DevCard::Knight] > 0 && partner.resources[r] > 0)
+                {
+                    actions.push_back(Action::sellKnight(other, 1, (Resource)r, 1));
+                }
+                if (partner.devCards[(size_t)DevCard::Knight] > 0 && player.resources[r] > 0)
+                {
+                    actions.push_back(Action::buyKnight(other, 1, (Resource)r, 1));
+                }
+            }
+        }
+    }
+
+    bool GameState::isGameEnded() const
+    {
+        return getWinner() >= 0;
+    }
+
+    int GameState::getWinner() const
+    {
+        for (int i = 0; i < numOfPlayers; i++)
+        {
+            if (players[(size_t)i].points() >= 10)
+            {
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    const VertexMask &GameState::getLegalSettlements(uint8_t player, bool firstRound) const
+    {
+        return firstRound ? openVertices : players[player].legalSettlements;
+    }
+
+    const EdgeMask &GameState::getLegalRoads(uint8_t player) const
+    {
+        static const EdgeMask empty;
+        return players[player].roadsLeft() > 0 ? players[player].legalRoads : empty;
+    }
+
+    const VertexMask &GameState::getLegalUpgrades(uint8_t player) const
+    {
+        return players[player].settlements;
+    }
+
+    /**
+     * Pays every building on the tiles with the rolled number, or makes every
+     * player with more than 7 cards discard half of them on a 7.
+     *
+     * @param result The sum of the two dice.
+     */
+    void GameState::applyRoll(int result)
+    {
+        lastRoll = (int8_t)result;
+
+        if (result == 7)
+        {
+            for (size_t i = 0; i < numOfPlayers; i++)
+            {
+                discardHalf(players[i]);
+            }
+            return;
+        }
+
+        for (int t = 0; t < NUM_TILES; t++)
+        {
+            if (tileNumbers[(size_t)t] != result || tileResources[(size_t)t] == NUM_RESOURCES)
+            {
+                continue;
+            }
+            size_t resource = tileResources[(size_t)t];
+            for (int v : standardTopology().tileVertices[t])
+            {
+                if (!buildings.test(v))
+                {
+                    continue;
+                }
+                for (size_t i = 0; i < numOfPlayers; i++)
+                {
+                    int amount = players[i].cities.test(v) ? 2 : players[i].settlements.test(v) ? 1 : 0;
+                    players[i].resources[resource] = (int16_t)(players[i].resources[resource] + amount);
+                    produced[resource] += amount;
+                }
+            }
+        }
+    }
+
+    // Discards half of a hand of more than 7 cards at random, like Player::itsSeven
+    void GameState::discardHalf(PlayerState &player)
+    {
+        int total = player.totalResources();
+        if (total <= 7)
+        {
+            return;
+        }
+        for (int i = 0; i < total / 2; i++)
+        {
+            size_t available[NUM_RESOURCES];
+            size_t count = 0;
+            for (size_t r = 0; r < NUM_RESOURCES; r++)
+            {
+                if (player.resources[r] > 0)
+                {
+                    available[count++] = r;
+                }
+            }
+            if (count > 0)
+            {
+                player.resources[available[rng.below((uint32_t)count)]]--;
+            }
+        }
+    }
+
+    // Puts a settlement on a vertex and updates the legal-move sets, like Board::placeSettlementAtVertex
+    void GameState::placeSettlementAt(uint8_t player, int vertexId)
+    {
+        const AdjacencyMasks &adjacency = adjacencyMasks();
+        players[player].settlements.set(vertexId);
+        buildings.set(vertexId);
+
+        VertexMask closed = adjacency.vertexNeighbors[(size_t)vertexId];
+        closed.set(vertexId);
+        openVertices = openVertices.without(closed);
+        for (size_t i = 0; i < numOfPlayers; i++)
+        {
+            players[i].legalSettlements = players[i].legalSettlements.without(closed);
+        }
+        players[player].legalRoads |= adjacency.vertexEdges[(size_t)vertexId].without(roads);
+        for (uint8_t i = 0; i < numOfPlayers; i++)
+        {
+            if (i != player)
+            {
+                (adjacency.vertexEdges[(size_t)vertexId] & players[i].legalRoads).forEach([&](int e) {
+                    if (!connectsRoad(i, e))
+                    {
+                        players[i].legalRoads.reset(e);
+                    }
+                });
+            }
+        }
+
+        // A settlement between two roads of another player cuts them apart
+        for (uint8_t i = 0; i < numOfPlayers; i++)
+        {
+            if (i != player && (adjacency.vertexEdges[(size_t)vertexId] & players[i].roads).count() >= 2)
+            {
+                players[i].roadLength = (uint8_t)longestRoad(players[i].roads, blockedFor(i));
+            }
+        }
+    }
+
+    // Puts a road on an edge and updates the legal-move sets, like Board::placeRoadAtEdge
+    void GameState::placeRoadAt(uint8_t player, int edgeId)
+    {
+        const AdjacencyMasks &adjacency = adjacencyMasks();
+        players[player].roads.set(edgeId);
+        roads.set(edgeId);
+
+        for (size_t i = 0; i < numOfPlayers; i++)
+        {
+            players[i].legalRoads.reset(edgeId);
+        }
+        players[player].legalRoads |= roadExtensions(player, edgeId).without(roads);
+        players[player].legalSettlements |= adjacency.edgeVertices[(size_t)edgeId] & openVertices;
+
+        // Only the network the road joins can get longer
+        VertexMask blocked = blockedFor(player);
+        int length = longestTrail(roadNetwork(edgeId, players[player].roads, blocked), blocked);
+        players[player].roadLength = (uint8_t)max((int)players[player].roadLength, length);
+    }
+
+    // Vertices holding another player's building, which the player's roads cannot pass
+    VertexMask GameState::blockedFor(uint8_t player) const
+    {
+        return buildings.without(players[player].settlements | players[player].cities);
+    }
+
+    // Edges a road on an edge leads on to: those at either end, unless another player's building stands there
+    EdgeMask GameState::roadExtensions(uint8_t player, int edgeId) const
+    {
+        const AdjacencyMasks &adjacency = adjacencyMasks();
+        VertexMask blocked = blockedFor(player);
+        EdgeMask extensions;
+        adjacency.edgeVertices[(size_t)edgeId].without(blocked).forEach([&](int v) { extensions |= adjacency.vertexEdges[(size_t)v]; });
+        extensions.reset(edgeId);
+        return extensions;
+    }
+
+    // Whether a road on an edge would connect to the player's pieces, like Board::connectsRoad
+    bool GameState::connectsRoad(uint8_t player, int edgeId) const
+    {
+        const VertexMask &ends = adjacencyMasks().edgeVertices[(size_t)edgeId];
+        return ends.intersects(players[player].settlements | players[player].cities) ||
+               roadExtensions(player, edgeId).intersects(players[player].roads);
+    }
+
+    // Passes the Longest Road card on after a road was built or cut, like Catan::updateLongestRoad
+    void GameState::updateLongestRoad()
+    {
+        longestRoadHolder = awardLongestRoad(longestRoadHolder, numOfPlayers, [&](uint8_t player) { return (int)players[player].roadLength; });
+        for (uint8_t i = 0; i < numOfPlayers; i++)
+        {
+            players[i].longestRoad = i == longestRoadHolder ? 1 : 0;
+        }
+    }
+
+    ActionResult GameState::validateSettlement(uint8_t player, int vertexId, bool firstRound) const
+    {
+        if (vertexId < 0 || vertexId >= NUM_VERTICES)
+        {
+            return ActionResult::InvalidLocation;
+        }
+        if (buildings.test(vertexId))
+        {
+            return ActionResult::LocationOccupied;
+        }
+        if (!firstRound && !adjacencyMasks().vertexEdges[(size_t)vertexId].intersects(players[player].roads))
+        {
+            return ActionResult::NotConnected;
+        }
+        if (adjacencyMasks().vertexNeighbors[(size_t)vertexId].intersects(buildings))
+        {
+            return ActionResult::AdjacentSettlement;
+        }
+        return ActionResult::Success;
+    }
+
+    ActionResult GameState::validateRoad(uint8_t player, int edgeId) const
+    {
+        if (edgeId < 0 || edgeId >= NUM_EDGES)
+        {
+            return ActionResult::InvalidLocation;
+        }
+        if (roads.test(edgeId))
+        {
+            return ActionResult::LocationOccupied;
+        }
+        if (players[player].roadsLeft() <= 0)
+        {
+            return ActionResult::NoRoadsLeft;
+        }
+        return players[player].legalRoads.test(edgeId) ? ActionResult::Success : ActionResult::NotConnected;
+    }
+
+    // The first two settlements of every player are free and need no road
+    ActionResult GameState::placeSettlement(uint8_t player, int vertexId)
+    {
+        PlayerState &state = players[player];
+        bool firstRound = state.numOfSettlements + state.numOfCities < 2;
+        if (!firstRound && !state.canAfford(Purchase::Settlement))
+        {
+            return ActionResult::InsufficientResources;
+        }
+        ActionResult result = validateSettlement(player, vertexId, firstRound);
+        if (result != ActionResult::Success)
+        {
+            return result;
+        }
+
+        placeSettlementAt(player, vertexId);
+        state.numOfSettlements++;
+        if (!firstRound)
+        {
+            state.pay(Purchase::Settlement);
+        }
+        updateLongestRoad();
+        return ActionResult::Success;
+    }
+
+    ActionResult GameState::placeRoad(uint8_t player, int edgeId)
+    {
+        PlayerState &state = players[player];
+        if (!state.canAfford(Purchase::Road))
+        {
+            return ActionResult::InsufficientResources;
+        }
+        ActionResult result = validateRoad(player, edgeId);
+        if (result != ActionResult::Success)
+        {
+            return result;
+        }
+
+        placeRoadAt(player, edgeId);
+        state.pay(Purchase::Road);
+        updateLongestRoad();
+        return ActionResult::Success;
+    }
+
+    ActionResult GameState::upgradeSettlement(uint8_t player, int vertexId)
+    {
+        PlayerState &state = players[player];
+        if (!state.canAfford(Purchase::City))
+        {
+            return ActionResult::InsufficientResources;
+        }
+        if (vertexId < 0 || vertexId >= NUM_VERTICES)
+        {
+            return ActionResult::InvalidLocation;
+        }
+        if (!state.settlements.test(vertexId))
+        {
+            return ActionResult::NotOwnSettlement;
+        }
+
+        state.settlements.reset(vertexId);
+        state.cities.set(vertexId);
+        state.pay(Purchase::City);
+        state.numOfCities++;
+        state.numOfSettlements--;
+        return ActionResult::Success;
+    }
+
+    // Draws uniformly among the card types still available, like Catan::buyDevelopmentCard
+    ActionResult GameState::buyDevelopmentCard(uint8_t player)
+    {
+        PlayerState &state = players[player];
+        if (!state.canAfford(Purchase::DevelopmentCard))
+        {
+            return ActionResult::InsufficientResources;
+        }
+        state.pay(Purchase::DevelopmentCard);
+
+        DevCard available[NUM_DEV_CARDS];
+        size_t count = 0;
+        for (size_t i = 0; i < NUM_DEV_CARDS; i++)
+        {
+            DevCard card = (DevCard)i;
+            if ((card == DevCard::Knight && knightsLeft == 0) || (card == DevCard::VictoryPoint && VPleft == 0))
+            {
+                continue;
+            }
+            available[count++] = card;
+        }
+
+        lastDevelopmentCard = available[rng.below((uint32_t)count)];
+        if (lastDevelopmentCard == DevCard::Knight)
+        {
+            knightsLeft--;
+        }
+        else if (lastDevelopmentCard == DevCard::VictoryPoint)
+        {
+            VPleft--;
+        }
+        state.devCards[(size_t)lastDevelopmentCard]++;
+        return ActionResult::Success;
+    }
+
+    ActionResult GameState::playYearOfPlenty(uint8_t player, Resource first, Resource second)
+    {
+        if (!isResource(first) || !isResource(second))
+        {
+            return ActionResult::InvalidTrade;
+        }
+        PlayerState &state = players[player];
+        if (state.devCards[(size_t)DevCard::YearOfPlenty] <= 0)
+        {
+            return ActionResult::NoDevelopmentCard;
+        }
+        state.resources[(size_t)first]++;
+        state.resources[(size_t)second]++;
+        state.devCards[(size_t)DevCard::YearOfPlenty]--;
+        return ActionResult::Success;
+    }
+
+    ActionResult GameState::playMonopoly(uint8_t player, Resource resource)
+    {
+        if (!isResource(resource))
+        {
+            return ActionResult::InvalidTrade;
+        }
+        PlayerState &state = players[player];
+        if (state.devCards[(size_t)DevCard::Monopoly] <= 0)
+        {
+            return ActionResult::NoDevelopmentCard;
+        }
+        for (size_t i = 0; i < numOfPlayers; i++)
+        {
+            if (i != player)
+            {
+                state.resources[(size_t)resource] = (int16_t)(state.resources[(size_t)resource] + players[i].resources[(size_t)resource]);
+                players[i].resources[(size_t)resource] = 0;
+            }
+        }
+        state.devCards[(size_t)DevCard::Monopoly]--;
+        return ActionResult::Success;
+    }
+
+    // Places two free roads; the second may extend the first, like Catan::playRoadBuilding
+    ActionResult GameState::playRoadBuilding(uint8_t player, int firstEdge, int secondEdge)
+    {
+        PlayerState &state = players[player];
+        if (state.devCards[(size_t)DevCard::RoadBuilding] <= 0)
+        {
+            return ActionResult::NoDevelopmentCard;
+        }
+        ActionResult result = validateRoad(player, firstEdge);
+        if (result != ActionResult::Success)
+        {
+            return result;
+        }
+        if (secondEdge == firstEdge)
+        {
+            return ActionResult::LocationOccupied;
+        }
+        if (state.roadsLeft() < 2)
+        {
+            return ActionResult::NoRoadsLeft;
+        }
+        if (secondEdge < 0 || secondEdge >= NUM_EDGES || roads.test(secondEdge))
+        {
+            return ActionResult::InvalidLocation;
+        }
+        if (!state.legalRoads.test(secondEdge) && !roadExtensions(player, firstEdge).test(secondEdge))
+        {
+            return ActionResult::NotConnected;
+        }
+
+        placeRoadAt(player, firstEdge);
+        placeRoadAt(player, secondEdge);
+        state.devCards[(size_t)DevCard::RoadBuilding]--;
+        updateLongestRoad();
+        return ActionResult::Success;
+    }
+
+    ActionResult GameState::trade(uint8_t player, uint8_t other, Resource give, Resource receive, int giveAmount, int receiveAmount)
+    {
+        if (!isResource(give) || !isResource(receive) || give == receive || giveAmount <= 0 || receiveAmount <= 0)
+        {
+            return ActionResult::InvalidTrade;
+        }
+        PlayerState &first = players[player];
+        PlayerState &second = players[other];
+        if (first.resources[(size_t)give] < giveAmount || second.resources[(size_t)receive] < receiveAmount)
+        {
+            return ActionResult::InsufficientResources;
+        }
+        first.resources[(size_t)give] = (int16_t)(first.resources[(size_t)give] - giveAmount);
+        second.resources[(size_t)give] = (int16_t)(second.resources[(size_t)give] + giveAmount);
+        first.resources[(size_t)receive] = (int16_t)(first.resources[(size_t)receive] + receiveAmount);
+        second.resources[(size_t)receive] = (int16_t)(second.resources[(size_t)receive] - receiveAmount);
+        return ActionResult::Success;
+    }
+
+    // The seller hands knights to the buyer, who pays with a resource
+    ActionResult GameState::sellKnight(uint8_t seller, uint8_t buyer, int knights, Resource resource, int amount)
+    {
+        if (!isResource(resource) || knights <= 0 || amount <= 0)
+        {
+            return ActionResult::InvalidTrade;
+        }
+        PlayerState &from = players[seller];
+        PlayerState &to = players[buyer];
+        if (knights > from.devCards[(size_t)DevCard::Knight])
+        {
+            return ActionResult::NoDevelopmentCard;
+        }
+        if (to.resources[(size_t)resource] < amount)
+        {
+            return ActionResult::InsufficientResources;
+        }
+        to.resources[(size_t)resource] = (int16_t)(to.resources[(size_t)resource] - amount);
+        from.resources[(size_t)resource] = (int16_t)(from.resources[(size_t)resource] + amount);
+        from.devCards[(size_t)DevCard::Knight] = (int16_t)(from.devCards[(size_t)DevCard::Knight] - knights);
+        to.devCards[(size_t)DevCard::Knight] = (int16_t)(to.devCards[(size_t)DevCard::Knight] + knights);
+        return ActionResult::Success;
+    }
+}
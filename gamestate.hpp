@@ -0,0 +1,129 @@
+#ifndef GAMESTATE_HPP
+#define GAMESTATE_HPP
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+#include "catan.hpp"
+#include "action.hpp"
+#include "bitboard.hpp"
+#include "topology.hpp"
+#include "rng.hpp"
+
+using namespace std;
+
+namespace ariel
+{
+
+    // The part of a player that matters to the rules, without the name
+    struct PlayerState
+    {
+        array<int16_t, NUM_RESOURCES> resources; // Indexed by Resource
+        array<int16_t, NUM_DEV_CARDS> devCards;  // Indexed by DevCard
+        uint8_t numOfSettlements;
+        uint8_t numOfCities;
+        uint8_t roadLength;          // Roads on the player's longest road
+        uint8_t longestRoad;         // 1 while the player holds the Longest Road card
+        VertexMask settlements;      // Vertices holding the player's settlements
+        VertexMask cities;           // Vertices holding the player's cities
+        EdgeMask roads;              // Edges holding the player's roads
+        VertexMask legalSettlements; // Open vertices at the end of the player's roads
+        EdgeMask legalRoads;         // Free edges touching the player's buildings, or their roads away from other players' buildings
+
+        int totalResources() const;
+        int roadsLeft() const { return MAX_ROADS - roads.count(); }
+        int points() const;
+        bool canAfford(Purchase purchase) const;
+        void pay(Purchase purchase);
+    };
+
+    // A complete game in one flat, trivially copyable block of a few hundred bytes.
+    // Copying it is a memcpy, so tree search can clone positions freely. It applies
+    // actions with the same rules and the same random draws as Catan, so a state
+    // taken from a game and the game itself stay identical under the same actions.
+    class GameState
+    {
+    public:
+        // Seats kept in the flat block; games with more players cannot be searched
+        static const int MAX_PLAYERS = 8;
+
+        Rng rng;
+        uint64_t seed;
+        array<PlayerState, MAX_PLAYERS> players;
+        array<uint8_t, NUM_TILES> tileResources; // Resource of each tile, NUM_RESOURCES for the desert
+        array<uint8_t, NUM_TILES> tileNumbers;   // Dice number of each tile
+        array<int32_t, NUM_RESOURCES> produced;  // Resources handed out by dice rolls, per type
+        VertexMask buildings;                    // Every settlement and city
+        EdgeMask roads;                          // Every road
+        VertexMask openVertices;                 // Free vertices with no building next to them
+        uint8_t numOfPlayers;
+        uint8_t currentPlayer;
+        uint8_t longestRoadHolder; // Seat holding the Longest Road card, or NO_PLAYER
+        int8_t knightsLeft;
+        int8_t VPleft;
+        int8_t lastRoll;
+        DevCard lastDevelopmentCard;
+
+        GameState() = default;
+
+        // Takes a snapshot of a game
+        explicit GameState(Catan &game);
+
+        // Writes the state back into a game with the same number of players, keeping the names.
+        // An attached journal starts an empty history and an attached record is detached.
+        void restore(Catan &game) const;
+
+        // Applies an action for the current player, exactly like Catan::apply
+        ActionResult apply(const Action &action);
+
+        // Settles a dice roll with the given result, as if the dice had shown it
+        void applyRoll(int result);
+
+        // Lists the actions worth searching for the current player: every affordable
+        // build, every playable card, one-card knight trades and ending the turn
+        void legalActions(vector<Action> &actions) const;
+
+        // True once a player has 10 points
+        bool isGameEnded() const;
+
+        // Seat of the player with 10 points or more, or -1
+        int getWinner() const;
+
+        // Where the current player may build, regardless of cost
+        const VertexMask &getLegalSettlements(uint8_t player, bool firstRound) const;
+        const EdgeMask &getLegalRoads(uint8_t player) const;
+        const VertexMask &getLegalUpgrades(uint8_t player) const;
+
+        // Bitwise comparison of two states
+        bool operator==(const GameState &other) const { return memcmp(this, &other, sizeof(GameState)) == 0; }
+        bool operator!=(const GameState &other) const { return !(*this == other); }
+
+    private:
+        void clear();
+        void discardHalf(PlayerState &player);
+        void placeSettlementAt(uint8_t player, int vertexId);
+        void placeRoadAt(uint8_t player, int edgeId);
+        VertexMask blockedFor(uint8_t player) const;
+        EdgeMask roadExtensions(uint8_t player, int edgeId) const;
+        bool connectsRoad(uint8_t player, int edgeId) const;
+        void updateLongestRoad();
+        ActionResult validateSettlement(uint8_t player, int vertexId, bool firstRound) const;
+        ActionResult validateRoad(uint8_t player, int edgeId) const;
+        ActionResult placeSettlement(uint8_t player, int vertexId);
+        ActionResult placeRoad(uint8_t player, int edgeId);
+        ActionResult upgradeSettlement(uint8_t player, int vertexId);
+        ActionResult buyDevelopmentCard(uint8_t player);
+        ActionResult playYearOfPlenty(uint8_t player, Resource first, Resource second);
+        ActionResult playMonopoly(uint8_t player, Resource resource);
+        ActionResult playRoadBuilding(uint8_t player, int firstEdge, int secondEdge);
+        ActionResult trade(uint8_t player, uint8_t other, Resource give, Resource receive, int giveAmount, int receiveAmount);
+        ActionResult sellKnight(uint8_t player, uint8_t other, int knights, Resource resource, int amount);
+    };
+
+    static_assert(is_trivially_copyable<GameState>::value, "GameState must be copyable with memcpy");
+}
+
+#endif
@@ -0,0 +1,243 @@
+#include "journal.hpp"
+#include "catan.hpp"
+
+namespace ariel
+{
+
+    Journal::Journal() : recording(false), redoing(false)
+    {
+    }
+
+    /**
+     * Opens a move. The counters of the game are saved here; the board, hand and
+     * card changes are added by the board and the players as they happen.
+     *
+     * @param game The game the move is applied to.
+     * @param op The kind of move.
+     * @param action The action, for moves that are actions.
+     */
+    void Journal::begin(Catan &game, RecordOp op, const Action &action)
+    {
+        Entry entry;
+        entry.op = op;
+        entry.action = action;
+        entry.firstChange = changes.size();
+        entry.rng = game.rng;
+        entry.currentPlayerIndex = game.currentPlayerIndex;
+        entry.longestRoadHolder = game.longestRoadHolder;
+        entry.knightsLeft = game.knightsLeft;
+        entry.VPleft = game.VPleft;
+        entry.lastRoll = game.lastRoll;
+        entry.lastDevelopmentCard = game.lastDevelopmentCard;
+        entry.produced = game.produced;
+        entry.record = game.record;
+        entry.recordMoves = game.record ? game.record->getNumOfMoves() : 0;
+        entry.recordBytes = game.record ? game.record->getSizeInBytes() : 0;
+        entries.push_back(entry);
+        recording = true;
+    }
+
+    void Journal::commit()
+    {
+        recording = false;
+        if (!redoing)
+        {
+            undone.clear();
+        }
+    }
+
+    void Journal::rollback(Catan &game)
+    {
+        recording = false;
+        restore(game);
+    }
+
+    /**
+     * Takes back one change. Placements are removed piece by piece; the legal-move
+     * sets they touched are restored from the copies saved before the placement.
+     *
+     * @param game The game the change was made to.
+     * @param change The change to take back.
+     */
+    void Journal::revert(Catan &game, const Change &change)
+    {
+        Board &board = game.board;
+        Player &player = game.players[change.player];
+        int location = change.value;
+
+        switch (change.kind)
+        {
+        case ChangeKind::Resource:
+            player.changeResource(change.type, -change.value);
+            break;
+
+        case ChangeKind::DevCard:
+            player.changeDevelopmentCard(change.type, -change.value);
+            break;
+
+        case ChangeKind::SettlementCount:
+            player.numOfSettlements--;
+            break;
+
+        case ChangeKind::CityCount:
+            player.numOfCities--;
+            player.numOfSettlements++;
+            break;
+
+        case ChangeKind::Settlement:
+            board.vertices[(size_t)location] = Vertex(location);
+            board.settlementMasks[change.player].reset(location);
+            board.buildings.reset(location);
+            board.hash ^= zobrist::settlement(location, change.player);
+
+            // Roads the settlement had cut are joined again
+            for (size_t i = 0; i < board.roadNetworks.size(); i++)
+            {
+                if (i != change.player && (board.roadMasks[i] & adjacencyMasks().vertexEdges[(size_t)location]).count() >= 2)
+                {
+                    board.rebuildRoadNetworks((uint8_t)i);
+                }
+            }
+
+            // Moves are undone in reverse order, so the settlement's production entries are the last ones
+            for (int tileIndex : standardTopology().vertexTiles[location])
+            {
+                const Tile &tile = board.getTile(tileIndex);
+                if (!tile.desert)
+                {
+                    board.production[(size_t)tile.number].pop_back();
+                }
+            }
+            break;
+
+        case ChangeKind::City:
+            board.vertices[(size_t)location].type = Building::Settlement;
+            board.cityMasks[change.player].reset(location);
+            board.settlementMasks[change.player].set(location);
+            board.hash ^= zobrist::settlement(location, change.player) ^ zobrist::city(location, change.player);
+            for (int tileIndex : standardTopology().vertexTiles[location])
+            {
+                for (auto &entry : board.production[(size_t)board.getTile(tileIndex).number])
+                {
+                    if (entry.vertex == location)
+                    {
+                        entry.amount = 1;
+                    }
+                }
+            }
+            break;
+
+        case ChangeKind::Road:
+            board.edges[(size_t)location] = Edge(location);
+            board.roadMasks[change.player].reset(location);
+            board.roads.reset(location);
+            board.hash ^= zobrist::road(location, change.player);
+            board.rebuildRoadNetworks(change.player);
+            break;
+
+        case ChangeKind::OpenVertices:
+            board.openVertices = change.vertices;
+            break;
+
+        case ChangeKind::LegalSettlements:
+            board.legalSettlementMasks[change.player] = change.vertices;
+            break;
+
+        case ChangeKind::LegalRoads:
+            board.legalRoadMasks[change.player] = change.edges;
+            break;
+        }
+    }
+
+    // Takes back the last move, newest change first, and restores the counters saved with it
+    void Journal::restore(Catan &game)
+    {
+        const Entry &entry = entries.back();
+        for (size_t i = changes.size(); i > entry.firstChange; i--)
+        {
+            revert(game, changes[i - 1]);
+        }
+        changes.resize(entry.firstChange);
+
+        game.rng = entry.rng;
+        game.currentPlayerIndex = entry.currentPlayerIndex;
+        game.setLongestRoadHolder(entry.longestRoadHolder);
+        game.knightsLeft = entry.knightsLeft;
+        game.VPleft = entry.VPleft;
+        game.lastRoll = entry.lastRoll;
+        game.lastDevelopmentCard = entry.lastDevelopmentCard;
+        game.produced = entry.produced;
+        if (entry.record && entry.record == game.record)
+        {
+            entry.record->truncate(entry.recordMoves, entry.recordBytes);
+        }
+        entries.pop_back();
+    }
+
+    /**
+     * Takes back the last move.
+     *
+     * @param game The game the journal is attached to.
+     * @return True if a move was taken back, false if there was none.
+     */
+    bool Journal::undo(Catan &game)
+    {
+        if (entries.empty() || recording)
+        {
+            return false;
+        }
+        undone.push_back({entries.back().op, entries.back().action});
+        restore(game);
+        return true;
+    }
+
+    /**
+     * Applies the last undone move again. The random generator was restored by the
+     * undo, so the move has the same outcome as the first time.
+     *
+     * @param game The game the journal is attached to.
+     * @return True if a move was applied again, false if there was none.
+     */
+    bool Journal::redo(Catan &game)
+    {
+        if (undone.empty() || recording)
+        {
+            return false;
+        }
+        Move move = undone.back();
+        undone.pop_back();
+
+        redoing = true;
+        if (move.op == RecordOp::NextPlayer)
+        {
+            game.nextPlayer();
+        }
+        else if (move.op == RecordOp::PreviousPlayer)
+        {
+            game.previousPlayer();
+        }
+        else
+        {
+            game.apply(move.action);
+        }
+        redoing = false;
+        return true;
+    }
+
+    void Journal::clear()
+    {
+        changes.clear();
+        entries.clear();
+        undone.clear();
+    }
+
+    size_t Journal::getNumOfMoves() const
+    {
+        return entries.size();
+    }
+
+    size_t Journal::getNumOfUndoneMoves() const
+    {
+        return undone.size();
+    }
+}
@@ -0,0 +1,125 @@
+#ifndef JOURNAL_HPP
+#define JOURNAL_HPP
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "action.hpp"
+#include "bitboard.hpp"
+#include "record.hpp"
+#include "rng.hpp"
+
+using namespace std;
+
+namespace ariel
+{
+
+    class Catan;
+
+    // Kinds of reversible changes made by an action
+    enum class ChangeKind : uint8_t
+    {
+        Resource,         // A player's amount of a resource changed by amount
+        DevCard,          // A player's number of cards of a type changed by amount
+        SettlementCount,  // A player's settlement count went up by one
+        CityCount,        // A player's settlement became a city in the counts
+        Settlement,       // A settlement was placed on location
+        City,             // The settlement on location became a city
+        Road,             // A road was placed on location
+        OpenVertices,     // The open vertices before a placement
+        LegalSettlements, // A player's legal settlements before a placement
+        LegalRoads        // A player's legal roads before a placement
+    };
+
+    // One reversible change: the minimal delta needed to take it back
+    struct Change
+    {
+        ChangeKind kind;
+        uint8_t player;
+        uint8_t type;        // Resource or DevCard index
+        int value;           // Amount, or the vertex or edge ID
+        VertexMask vertices; // Previous vertex set, for OpenVertices and LegalSettlements
+        EdgeMask edges;      // Previous edge set, for LegalRoads
+    };
+
+    // A reversible history of the moves applied to a game, for undo/redo and for
+    // make/unmake in tree search. Every move keeps the board, hand and card changes
+    // it made, plus the few counters of the game, so undoing it costs time in
+    // proportion to what it changed rather than a copy of the whole game.
+    //
+    // A journal starts recording when it is attached to a game with Catan::setJournal.
+    // Successful actions and the changes of seat made by nextPlayer and previousPlayer
+    // are moves; rejected actions leave no trace. Undoing a move also takes it out of
+    // the game's record, so a record stays a replay of the game on the board.
+    class Journal
+    {
+    private:
+        // The start of a move: what it was and the counters it may change
+        struct Entry
+        {
+            RecordOp op;
+            Action action;
+            size_t firstChange;
+            Rng rng;
+            size_t currentPlayerIndex;
+            uint8_t longestRoadHolder;
+            int knightsLeft;
+            int VPleft;
+            int lastRoll;
+            DevCard lastDevelopmentCard;
+            array<int, NUM_RESOURCES> produced;
+            GameRecord *record;  // Record attached to the game when the move began, if any
+            size_t recordMoves;  // Its moves and bytes before the move, to take the move out again
+            size_t recordBytes;
+        };
+
+        // A move that was undone and can be redone
+        struct Move
+        {
+            RecordOp op;
+            Action action;
+        };
+
+        vector<Change> changes;
+        vector<Entry> entries;
+        vector<Move> undone;
+        bool recording; // A move is being applied
+        bool redoing;   // The move being applied comes from the redo list
+
+        void revert(Catan &game, const Change &change);
+        void restore(Catan &game);
+
+    public:
+        Journal();
+
+        // True while a move is being applied; changes are only kept then
+        bool isRecording() const { return recording; }
+
+        // Appends one change to the move being applied
+        void add(const Change &change) { changes.push_back(change); }
+
+        // Opens a move before it is applied, saving the counters of the game
+        void begin(Catan &game, RecordOp op, const Action &action);
+
+        // Closes the move being applied; a new move clears the redo list
+        void commit();
+
+        // Takes back the move being applied, for actions that were rejected
+        void rollback(Catan &game);
+
+        // Takes back the last move; returns false if there is none
+        bool undo(Catan &game);
+
+        // Applies the last undone move again; returns false if there is none
+        bool redo(Catan &game);
+
+        // Forgets every move, keeping the game as it is
+        void clear();
+
+        size_t getNumOfMoves() const;
+        size_t getNumOfUndoneMoves() const;
+    };
+}
+
+#endif
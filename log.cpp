@@ -0,0 +1,153 @@
+#include "log.hpp"
+
+#include <cctype>
+#include <stdexcept>
+
+namespace ariel
+{
+
+    atomic<int> Logger::threshold((int)LogLevel::Info);
+    atomic<LogSink *> Logger::sink(nullptr);
+
+    static const char *const LEVEL_NAMES[] = {"TRACE", "DEBUG", "INFO", "WARN", "ERROR", "OFF"};
+
+    const char *levelName(LogLevel level)
+    {
+        return LEVEL_NAMES[(size_t)level];
+    }
+
+    LogLevel parseLevel(const string &name)
+    {
+        string upper;
+        for (char c : name)
+        {
+            upper += (char)toupper((unsigned char)c);
+        }
+        for (size_t i = 0; i <= (size_t)LogLevel::Off; i++)
+        {
+            if (upper == LEVEL_NAMES[i])
+            {
+                return (LogLevel)i;
+            }
+        }
+        throw invalid_argument("Unknown log level: " + name);
+    }
+
+    StreamSink::StreamSink(ostream &out, size_t capacity) : out(out), capacity(capacity)
+    {
+        buffer.reserve(capacity);
+    }
+
+    StreamSink::~StreamSink()
+    {
+        flush();
+    }
+
+    // Writes the buffer to the stream; the lock must be held
+    void StreamSink::drain()
+    {
+        out.write(buffer.data(), (streamsize)buffer.size());
+        buffer.clear();
+    }
+
+    /**
+     * Appends a line to the buffer, writing the buffer out once it is full.
+     *
+     * @param level The level of the message.
+     * @param line The message.
+     */
+    void StreamSink::write(LogLevel level, const string &line)
+    {
+        lock_guard<mutex> guard(lock);
+        buffer += '[';
+        buffer += levelName(level);
+        buffer += "] ";
+        buffer += line;
+        buffer += '\n';
+        if (buffer.size() >= capacity)
+        {
+            drain();
+        }
+    }
+
+    void StreamSink::flush()
+    {
+        lock_guard<mutex> guard(lock);
+        drain();
+        out.flush();
+    }
+
+    RingSink::RingSink(size_t capacity) : ring(capacity == 0 ? 1 : capacity), next(0), total(0) {}
+
+    void RingSink::write(LogLevel level, const string &line)
+    {
+        lock_guard<mutex> guard(lock);
+        string &slot = ring[next];
+        slot = "[";
+        slot += levelName(level);
+        slot += "] ";
+        slot += line;
+        next = (next + 1) % ring.size();
+        total++;
+    }
+
+    vector<string> RingSink::lines() const
+    {
+        lock_guard<mutex> guard(lock);
+        vector<string> result;
+        size_t kept = total < ring.size() ? total : ring.size();
+        for (size_t i = 0; i < kept; i++)
+        {
+            result.push_back(ring[(next + ring.size() - kept + i) % ring.size()]);
+        }
+        return result;
+    }
+
+    FileSink::FileSink(const string &path, size_t capacity) : file(path, ios::app), stream(file, capacity)
+    {
+        if (!file)
+        {
+            throw runtime_error("Cannot open log file " + path);
+        }
+    }
+
+    void FileSink::write(LogLevel level, const string &line)
+    {
+        stream.write(level, line);
+    }
+
+    void FileSink::flush()
+    {
+        stream.flush();
+    }
+
+    void Logger::setLevel(LogLevel level)
+    {
+        threshold.store((int)level, memory_order_relaxed);
+    }
+
+    LogLevel Logger::getLevel()
+    {
+        return (LogLevel)threshold.load(memory_order_relaxed);
+    }
+
+    void Logger::setSink(LogSink *target)
+    {
+        sink.store(target);
+    }
+
+    /**
+     * Hands a formatted message to the current sink, if there is one.
+     *
+     * @param level The level of the message.
+     * @param message The message, without a trailing newline.
+     */
+    void Logger::write(LogLevel level, const string &message)
+    {
+        LogSink *target = sink.load();
+        if (target)
+        {
+            target->write(level, message);
+        }
+    }
+}
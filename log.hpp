@@ -0,0 +1,162 @@
+#ifndef LOG_HPP
+#define LOG_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <fstream>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Lowest level compiled into the program: 0 trace, 1 debug, 2 info, 3 warn, 4 error.
+// Messages below it are removed by the compiler, arguments included, so release
+// builds of the simulator pay nothing for the engine's debug logging.
+#ifndef CATAN_LOG_LEVEL
+#define CATAN_LOG_LEVEL 2
+#endif
+
+namespace ariel
+{
+
+    // Severity of a log message, from the most to the least verbose
+    enum class LogLevel : int
+    {
+        Trace,
+        Debug,
+        Info,
+        Warn,
+        Error,
+        Off
+    };
+
+    // Short upper case name of a level, like "DEBUG"
+    const char *levelName(LogLevel level);
+
+    // Parses a level name in any case, like "debug"; throws invalid_argument if unknown
+    LogLevel parseLevel(const string &name);
+
+    // Destination of log lines. Sinks may be written from several threads at once.
+    class LogSink
+    {
+    public:
+        virtual ~LogSink() {}
+
+        // Receives one formatted line, without the trailing newline
+        virtual void write(LogLevel level, const string &line) = 0;
+
+        // Pushes out any buffered lines
+        virtual void flush() {}
+    };
+
+    // Drops every line
+    class NullSink : public LogSink
+    {
+    public:
+        void write(LogLevel, const string &) override {}
+    };
+
+    // Collects lines in memory and hands them to a stream in large blocks, when the
+    // buffer is full or on flush, instead of flushing the stream on every line
+    class StreamSink : public LogSink
+    {
+    private:
+        ostream &out;
+        string buffer;
+        size_t capacity;
+        mutex lock;
+
+        void drain();
+
+    public:
+        StreamSink(ostream &out, size_t capacity = 64 * 1024);
+        ~StreamSink();
+
+        void write(LogLevel level, const string &line) override;
+        void flush() override;
+    };
+
+    // Keeps only the most recent lines, for dumping after a failure
+    class RingSink : public LogSink
+    {
+    private:
+        vector<string> ring;
+        size_t next;  // Slot of the next line
+        size_t total; // Lines written so far
+        mutable mutex lock;
+
+    public:
+        explicit RingSink(size_t capacity);
+
+        void write(LogLevel level, const string &line) override;
+
+        // The kept lines, oldest first
+        vector<string> lines() const;
+    };
+
+    // Buffered lines appended to a file
+    class FileSink : public LogSink
+    {
+    private:
+        ofstream file;
+        StreamSink stream;
+
+    public:
+        // Throws runtime_error if the file cannot be opened
+        explicit FileSink(const string &path, size_t capacity = 64 * 1024);
+
+        void write(LogLevel level, const string &line) override;
+        void flush() override;
+    };
+
+    // The process-wide logger. Messages go to one sink at a time, and nothing is
+    // formatted for levels below the runtime threshold. By default there is no sink,
+    // so the engine stays silent and formats nothing unless a program asks for a log.
+    class Logger
+    {
+    private:
+        static atomic<int> threshold;
+        static atomic<LogSink *> sink;
+
+    public:
+        // Messages below this level are skipped at run time
+        static void setLevel(LogLevel level);
+        static LogLevel getLevel();
+
+        // Sends the messages to a sink owned by the caller, or drops them for nullptr
+        static void setSink(LogSink *target);
+
+        // True if a message of this level would be written to a sink
+        static bool enabled(LogLevel level)
+        {
+            return (int)level >= threshold.load(memory_order_relaxed) &&
+                   sink.load(memory_order_relaxed) != nullptr;
+        }
+
+        static void write(LogLevel level, const string &message);
+    };
+}
+
+// Logs a message built with <<, like LOG_DEBUG("rolled " << result). The message is
+// only formatted when its level is compiled in and enabled and a sink is set.
+#define CATAN_LOG(level, message)                                                    \
+    do                                                                               \
+    {                                                                                \
+        if ((int)(level) >= CATAN_LOG_LEVEL && ariel::Logger::enabled(level))       \
+        {                                                                            \
+            ostringstream catanLogMessage;                                           \
+            catanLogMessage << message;                                              \
+            ariel::Logger::write(level, catanLogMessage.str());                      \
+        }                                                                            \
+    } while (0)
+
+#define LOG_TRACE(message) CATAN_LOG(ariel::LogLevel::Trace, message)
+#define LOG_DEBUG(message) CATAN_LOG(ariel::LogLevel::Debug, message)
+#define LOG_INFO(message) CATAN_LOG(ariel::LogLevel::Info, message)
+#define LOG_WARN(message) CATAN_LOG(ariel::LogLevel::Warn, message)
+#define LOG_ERROR(message) CATAN_LOG(ariel::LogLevel::Error, message)
+
+#endif
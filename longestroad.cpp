@@ -0,0 +1,102 @@
+#include "longestroad.hpp"
+
+#include <algorithm>
+
+namespace ariel
+{
+
+    /**
+     * Collects the roads reachable from a road without passing a blocked vertex.
+     *
+     * @param edgeId The road to start from.
+     * @param roads The roads of the player.
+     * @param blocked Vertices holding another player's building.
+     * @return The network containing the road.
+     */
+    EdgeMask roadNetwork(int edgeId, const EdgeMask &roads, const VertexMask &blocked)
+    {
+        const AdjacencyMasks &adjacency = adjacencyMasks();
+        const Topology &topology = standardTopology();
+        EdgeMask network = EdgeMask::single(edgeId);
+        EdgeMask frontier = network;
+        while (frontier.any())
+        {
+            EdgeMask reached;
+            frontier.forEach([&](int e) {
+                for (int v : topology.edgeVertices[e])
+                {
+                    if (!blocked.test(v))
+                    {
+                        reached |= adjacency.vertexEdges[(size_t)v];
+                    }
+                }
+            });
+            frontier = (reached & roads).without(network);
+            network |= frontier;
+        }
+        return network;
+    }
+
+    // Length of the longest trail leaving a vertex over the unused roads
+    static int trailFrom(int vertexId, EdgeMask &used, const EdgeMask &network, const VertexMask &blocked)
+    {
+        int best = 0;
+        (adjacencyMasks().vertexEdges[(size_t)vertexId] & network).without(used).forEach([&](int e) {
+            const IdList<2> &ends = standardTopology().edgeVertices[e];
+            int other = ends[0] == vertexId ? ends[1] : ends[0];
+            used.set(e);
+            int length = 1 + (blocked.test(other) ? 0 : trailFrom(other, used, network, blocked));
+            used.reset(e);
+            best = max(best, length);
+        });
+        return best;
+    }
+
+    /**
+     * Finds the longest road through a network by a depth-first search from the
+     * vertices where a longest road can start. A road starting at a vertex with an
+     * even number of the network's roads leaves one of them unused there, so it
+     * could be extended backwards; only vertices with an odd number of roads and
+     * blocked vertices need to be tried, or any vertex if there are none.
+     *
+     * @param network Connected roads of one player.
+     * @param blocked Vertices holding another player's building.
+     * @return The number of roads on the longest road.
+     */
+    int longestTrail(const EdgeMask &network, const VertexMask &blocked)
+    {
+        const AdjacencyMasks &adjacency = adjacencyMasks();
+        VertexMask ends;
+        network.forEach([&](int e) { ends |= adjacency.edgeVertices[(size_t)e]; });
+
+        VertexMask starts = ends & blocked;
+        ends.forEach([&](int v) {
+            if ((adjacency.vertexEdges[(size_t)v] & network).count() % 2 == 1)
+            {
+                starts.set(v);
+            }
+        });
+        if (starts.none() && ends.any())
+        {
+            starts.set(ends.first());
+        }
+
+        int best = 0;
+        EdgeMask used;
+        starts.forEach([&](int v) { best = max(best, trailFrom(v, used, network, blocked)); });
+        return best;
+    }
+
+    int longestRoad(const EdgeMask &roads, const VertexMask &blocked)
+    {
+        int best = 0;
+        EdgeMask remaining = roads;
+        while (remaining.any())
+        {
+            EdgeMask network = roadNetwork(remaining.first(), remaining, blocked);
+            best = max(best, longestTrail(network, blocked));
+            remaining = remaining.without(network);
+        }
+        return best;
+    }
+}
@@ -0,0 +1,60 @@
+#ifndef LONGESTROAD_HPP
+#define LONGESTROAD_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+#include "board.hpp"
+
+using namespace std;
+
+namespace ariel
+{
+
+    // Shortest road that earns the Longest Road card
+    const int MIN_LONGEST_ROAD = 5;
+
+    // Roads connected to the given road, which must be one of the roads
+    EdgeMask roadNetwork(int edgeId, const EdgeMask &roads, const VertexMask &blocked);
+
+    // Number of roads on the longest path through a network that uses every road at
+    // most once and does not pass through a blocked vertex (it may end there)
+    int longestTrail(const EdgeMask &network, const VertexMask &blocked);
+
+    // Longest road over all networks of a set of roads
+    int longestRoad(const EdgeMask &roads, const VertexMask &blocked);
+
+    // Returns the holder of the Longest Road card after road lengths changed. The
+    // holder keeps the card while no road is longer; a road of at least
+    // MIN_LONGEST_ROAD that is longer than every other takes it. If the holder's road
+    // is broken and several players tie for the longest, nobody holds the card.
+    template <typename Length>
+    uint8_t awardLongestRoad(uint8_t holder, size_t numOfPlayers, Length length)
+    {
+        int best = 0;
+        size_t leaders = 0;
+        uint8_t leader = NO_PLAYER;
+        for (size_t i = 0; i < numOfPlayers; i++)
+        {
+            int current = length((uint8_t)i);
+            if (current > best)
+            {
+                best = current;
+                leader = (uint8_t)i;
+                leaders = 1;
+            }
+            else if (current == best)
+            {
+                leaders++;
+            }
+        }
+
+        if (holder != NO_PLAYER && length(holder) >= MIN_LONGEST_ROAD && length(holder) == best)
+        {
+            return holder;
+        }
+        return best >= MIN_LONGEST_ROAD && leaders == 1 ? leader : NO_PLAYER;
+    }
+}
+
+#endif
@@ -0,0 +1,403 @@
+#include "mcts.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <thread>
+
+namespace ariel
+{
+
+    // Trees stop growing at this size; playouts still run from the leaves
+    static const size_t MAX_NODES = 1 << 20;
+
+    // One node of a search tree
+    struct Node
+    {
+        Action action;   // Action that leads to the node from its parent
+        int firstChild;  // Index of the first child, -1 until the node is expanded
+        int numChildren; // Children are stored next to each other
+        int visits;
+        double reward;   // Sum of the rewards of the player who chose the action
+        uint8_t player;  // Player who chose the action
+        bool chance;     // The turn has ended and the next step is a dice roll
+    };
+
+    // Picks a uniformly random member of a non-empty set
+    template <size_t Words>
+    static int randomMember(const BitBoard<Words> &set, Rng &rng)
+    {
+        int wanted = (int)rng.below((uint32_t)set.count());
+        int found = -1;
+        set.forEach([&](int index) {
+            if (wanted-- == 0)
+            {
+                found = index;
+            }
+        });
+        return found;
+    }
+
+    static Resource randomResource(Rng &rng)
+    {
+        return (Resource)rng.below((uint32_t)NUM_RESOURCES);
+    }
+
+    // Rolls two dice
+    static int rollDice(Rng &rng)
+    {
+        return rng.rollDie() + rng.rollDie();
+    }
+
+    // Chooses the next action of a playout: build the most valuable thing the player can afford
+    static Action playoutAction(const GameState &state, Rng &rng)
+    {
+        const PlayerState &player = state.players[state.currentPlayer];
+
+        if (player.canAfford(Purchase::City) && player.settlements.any())
+        {
+            return Action::upgradeSettlement(randomMember(player.settlements, rng));
+        }
+        if (player.canAfford(Purchase::Settlement) && player.legalSettlements.any())
+        {
+            return Action::placeSettlement(randomMember(player.legalSettlements, rng));
+        }
+        if (player.devCards[(size_t)DevCard::YearOfPlenty] > 0)
+        {
+            return Action::playYearOfPlenty(randomResource(rng), randomResource(rng));
+        }
+        if (player.devCards[(size_t)DevCard::Monopoly] > 0)
+        {
+            return Action::playMonopoly(randomResource(rng));
+        }
+        if (player.devCards[(size_t)DevCard::RoadBuilding] > 0 && player.roadsLeft() >= 2 && player.legalRoads.count() >= 2)
+        {
+            int first = randomMember(player.legalRoads, rng);
+            EdgeMask rest = player.legalRoads;
+            rest.reset(first);
+            return Action::playRoadBuilding(first, randomMember(rest, rng));
+        }
+        if (player.canAfford(Purchase::DevelopmentCard) && rng.below(2) == 0)
+        {
+            return Action::buyDevelopmentCard();
+        }
+        if (player.canAfford(Purchase::Road) && player.roadsLeft() > 0 && player.legalRoads.any() && (player.legalSettlements.none() || rng.below(4) == 0))
+        {
+            return Action::placeRoad(randomMember(player.legalRoads, rng));
+        }
+        return Action::endTurn();
+    }
+
+    /**
+     * Plays a state forward with a randomized greedy policy.
+     *
+     * The current player is assumed to have rolled already. Every later turn starts
+     * with a roll from the state's own generator.
+     *
+     * @param state The state to play forward.
+     * @param rng The generator used by the policy.
+     * @param turns The number of turns to play, counting the current one.
+     * @return The number of actions applied.
+     */
+    int playout(GameState &state, Rng &rng, int turns)
+    {
+        int applied = 0;
+        for (int turn = 0; turn < turns && !state.isGameEnded(); turn++)
+        {
+            if (turn > 0)
+            {
+                state.applyRoll(rollDice(state.rng));
+                applied++;
+            }
+            for (int i = 0; i < 8 && !state.isGameEnded(); i++)
+            {
+                Action action = playoutAction(state, rng);
+                if (action.type == ActionType::EndTurn)
+                {
+                    break;
+                }
+                state.apply(action);
+                applied++;
+            }
+            state.apply(Action::endTurn());
+            applied++;
+        }
+        return applied;
+    }
+
+    // Scores a position for every seat: a win is worth 1, otherwise the share of all points
+    static void score(const GameState &state, double rewards[GameState::MAX_PLAYERS])
+    {
+        int winner = state.getWinner();
+        int total = 0;
+        for (size_t i = 0; i < state.numOfPlayers; i++)
+        {
+            total += state.players[i].points();
+        }
+        for (size_t i = 0; i < state.numOfPlayers; i++)
+        {
+            if (winner >= 0)
+            {
+                rewards[i] = (int)i == winner ? 1.0 : 0.0;
+            }
+            else
+            {
+                rewards[i] = total > 0 ? (double)state.players[i].points() / total : 0.0;
+            }
+        }
+    }
+
+    // Adds the children of a node: one per legal action, or one per dice sum for a chance node
+    static void expand(vector<Node> &tree, int index, const GameState &state, vector<Action> &actions)
+    {
+        int first = (int)tree.size();
+        if (tree[(size_t)index].chance)
+        {
+            for (int roll = 2; roll <= 12; roll++)
+            {
+                Node child = {Action::rollDice(), -1, 0, 0, 0.0, state.currentPlayer, false};
+                tree.push_back(child);
+            }
+        }
+        else
+        {
+            state.legalActions(actions);
+            for (const Action &action : actions)
+            {
+                Node child = {action, -1, 0, 0, 0.0, state.currentPlayer, action.type == ActionType::EndTurn};
+                tree.push_back(child);
+            }
+        }
+        tree[(size_t)index].firstChild = first;
+        tree[(size_t)index].numChildren = (int)tree.size() - first;
+    }
+
+    // Picks the child with the best upper confidence bound, trying unvisited children first
+    static int selectChild(const vector<Node> &tree, const Node &node, double exploration)
+    {
+        double logVisits = log((double)node.visits + 1);
+        int best = node.firstChild;
+        double bestValue = -1;
+        for (int i = node.firstChild; i < node.firstChild + node.numChildren; i++)
+        {
+            const Node &child = tree[(size_t)i];
+            if (child.visits == 0)
+            {
+                return i;
+            }
+            double value = child.reward / child.visits + exploration * sqrt(logVisits / child.visits);
+            if (value > bestValue)
+            {
+                best = i;
+                bestValue = value;
+            }
+        }
+        return best;
+    }
+
+    /**
+     * Grows one search tree from the root until the budget runs out.
+     *
+     * @param root The position to search from.
+     * @param config The search budget and tuning.
+     * @param iterations Playouts to run, or 0 to run until the deadline.
+     * @param deadline Time at which to stop when iterations is 0.
+     * @param seed Seed of this tree's random draws, including the dice.
+     * @param visits Filled with the visit count of every root move.
+     * @return The number of playouts run.
+     */
+    static long growTree(const GameState &root, const MctsConfig &config, long iterations,
+                         chrono::steady_clock::time_point deadline, uint64_t seed, vector<int> &visits)
+    {
+        Rng rng(seed);
+        vector<Node> tree;
+        vector<Action> actions;
+        vector<int> path;
+        tree.reserve(4096);
+        tree.push_back({Action::endTurn(), -1, 0, 0, 0.0, root.currentPlayer, false});
+        expand(tree, 0, root, actions);
+
+        long playouts = 0;
+        while (iterations > 0 ? playouts < iterations : ((playouts & 15) != 0 || chrono::steady_clock::now() < deadline))
+        {
+            // The dice and card draws of this iteration must not be the ones of the real game
+            GameState state = root;
+            state.rng.reseed(rng.next());
+            path.clear();
+            path.push_back(0);
+
+            // Selection: walk down the tree, sampling the dice at chance nodes
+            int index = 0;
+            while (tree[(size_t)index].firstChild >= 0 && !state.isGameEnded())
+            {
+                const Node &node = tree[(size_t)index];
+                if (node.chance)
+                {
+                    int roll = rollDice(state.rng);
+                    index = node.firstChild + roll - 2;
+                    state.applyRoll(roll);
+                }
+                else
+                {
+                    index = selectChild(tree, node, config.exploration);
+                    state.apply(tree[(size_t)index].action);
+                }
+                path.push_back(index);
+            }
+
+            // Expansion: a leaf that has been visited before gets its children
+            if (!state.isGameEnded() && tree[(size_t)index].visits > 0 && tree.size() < MAX_NODES)
+            {
+                expand(tree, index, state, actions);
+                const Node &node = tree[(size_t)index];
+                if (node.chance)
+                {
+                    int roll = rollDice(state.rng);
+                    index = node.firstChild + roll - 2;
+                    state.applyRoll(roll);
+                }
+                else
+                {
+                    index = node.firstChild + (int)rng.below((uint32_t)node.numChildren);
+                    state.apply(tree[(size_t)index].action);
+                }
+                path.push_back(index);
+            }
+
+            // Simulation: a turn that just ended needs the next roll before playing on
+            if (tree[(size_t)index].chance && !state.isGameEnded())
+            {
+                state.applyRoll(rollDice(state.rng));
+            }
+            playout(state, rng, config.playoutTurns);
+            playouts++;
+
+            // Backpropagation: every node is credited with the reward of the player who chose it
+            double rewards[GameState::MAX_PLAYERS];
+            score(state, rewards);
+            for (int i : path)
+            {
+                Node &node = tree[(size_t)i];
+                node.visits++;
+                node.reward += rewards[node.player];
+            }
+        }
+
+        const Node &rootNode = tree[0];
+        visits.assign((size_t)rootNode.numChildren, 0);
+        for (int i = 0; i < rootNode.numChildren; i++)
+        {
+            visits[(size_t)i] = tree[(size_t)(rootNode.firstChild + i)].visits;
+        }
+        return playouts;
+    }
+
+    MctsBot::MctsBot(const MctsConfig &config) : config(config), statistics({0, 0.0})
+    {
+    }
+
+    const char *MctsBot::getName() const
+    {
+        return "mcts";
+    }
+
+    int MctsBot::chooseSetupSettlement(Catan &game, Rng &rng)
+    {
+        return setup.chooseSetupSettlement(game, rng);
+    }
+
+    int MctsBot::chooseSetupRoad(Catan &game, int settlement, Rng &rng)
+    {
+        return setup.chooseSetupRoad(game, settlement, rng);
+    }
+
+    // Tables too large for a GameState are played greedily
+    Action MctsBot::chooseAction(Catan &game, Rng &rng)
+    {
+        if (game.getNumOfPlayers() > (size_t)GameState::MAX_PLAYERS)
+        {
+            return setup.chooseAction(game, rng);
+        }
+        return search(GameState(game), rng.next());
+    }
+
+    /**
+     * Runs the search on the configured threads and returns the root move visited most often.
+     *
+     * @param root The position to search from; its current player has rolled.
+     * @param seed Seed of the search's random draws.
+     * @return The chosen action, or ending the turn if the game is over.
+     */
+    Action MctsBot::search(const GameState &root, uint64_t seed)
+    {
+        statistics = {0, 0.0};
+        if (root.isGameEnded())
+        {
+            return Action::endTurn();
+        }
+        vector<Action> actions;
+        root.legalActions(actions);
+        if (actions.empty())
+        {
+            return Action::endTurn();
+        }
+        if (actions.size() == 1)
+        {
+            return actions[0];
+        }
+
+        unsigned numOfThreads = config.threads ? config.threads : thread::hardware_concurrency();
+        if (numOfThreads == 0)
+        {
+            numOfThreads = 1;
+        }
+        long perThread = config.iterations > 0 ? (config.iterations + numOfThreads - 1) / numOfThreads : 0;
+        auto start = chrono::steady_clock::now();
+        auto deadline = start + chrono::milliseconds(config.timeLimitMs);
+
+        // Root parallelism: independent trees, merged by adding up the root visit counts
+        vector<vector<int>> visits(numOfThreads);
+        vector<long> playouts(numOfThreads, 0);
+        vector<thread> workers;
+        Rng seeds(seed);
+        for (unsigned t = 1; t < numOfThreads; t++)
+        {
+            uint64_t threadSeed = seeds.next();
+            workers.push_back(thread([&, t, threadSeed]() {
+                playouts[t] = growTree(root, config, perThread, deadline, threadSeed, visits[t]);
+            }));
+        }
+        playouts[0] = growTree(root, config, perThread, deadline, seeds.next(), visits[0]);
+        for (auto &worker : workers)
+        {
+            worker.join();
+        }
+
+        size_t best = 0;
+        long bestVisits = -1;
+        for (size_t i = 0; i < actions.size(); i++)
+        {
+            long total = 0;
+            for (const auto &counts : visits)
+            {
+                total += counts[i];
+            }
+            if (total > bestVisits)
+            {
+                best = i;
+                bestVisits = total;
+            }
+        }
+
+        for (long count : playouts)
+        {
+            statistics.playouts += count;
+        }
+        statistics.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        return actions[best];
+    }
+
+    const MctsStatistics &MctsBot::getStatistics() const
+    {
+        return statistics;
+    }
+}
@@ -0,0 +1,65 @@
+#ifndef MCTS_HPP
+#define MCTS_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include "bot.hpp"
+#include "gamestate.hpp"
+
+using namespace std;
+
+namespace ariel
+{
+
+    // Search budget and tuning of the Monte Carlo Tree Search bot
+    struct MctsConfig
+    {
+        long iterations;     // Playouts per decision over all threads; 0 to search until the time runs out
+        int timeLimitMs;     // Time per decision when iterations is 0
+        unsigned threads;    // Search threads started for every decision; 0 for one per core. The default of
+                             // 1 suits bots run by a GameScheduler, which already keeps every core busy
+        int playoutTurns;    // Turns played out before the position is scored
+        double exploration;  // UCT exploration constant
+
+        MctsConfig() : iterations(0), timeLimitMs(200), threads(1), playoutTurns(30), exploration(0.7) {}
+    };
+
+    // Counters of the last search
+    struct MctsStatistics
+    {
+        long playouts;  // Playouts over all threads
+        double seconds; // Wall clock time of the search
+    };
+
+    // Picks actions by Monte Carlo Tree Search over GameState. Every thread grows its
+    // own tree from the same root and the visit counts of the root moves are added up.
+    // The dice are chance nodes: after a turn ends, each roll leads to its own subtree,
+    // sampled with the odds of two dice.
+    class MctsBot : public Bot
+    {
+    private:
+        MctsConfig config;
+        MctsStatistics statistics;
+        GreedyBot setup; // The setup rounds, and games too large to search, are played greedily
+
+    public:
+        explicit MctsBot(const MctsConfig &config = MctsConfig());
+
+        const char *getName() const override;
+        int chooseSetupSettlement(Catan &game, Rng &rng) override;
+        int chooseSetupRoad(Catan &game, int settlement, Rng &rng) override;
+        Action chooseAction(Catan &game, Rng &rng) override;
+
+        // Searches from a state and returns the best action of its current player
+        Action search(const GameState &root, uint64_t seed);
+
+        const MctsStatistics &getStatistics() const;
+    };
+
+    // Plays a state forward with a fast randomized greedy policy for up to the given
+    // number of turns; returns the number of actions applied
+    int playout(GameState &state, Rng &rng, int turns);
+}
+
+#endif
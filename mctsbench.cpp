@@ -0,0 +1,147 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "simulation.hpp"
+#include "mcts.hpp"
+
+using namespace std;
+using namespace ariel;
+
+void usage()
+{
+    cerr << "Usage: mctsbench [--seed S] [--turns N] [--ms M] [--iterations I] [--threads T] [--searches K]" << endl;
+    exit(1);
+}
+
+// Short description of a chosen action
+string describe(const Action &action)
+{
+    static const char *names[] = {"roll dice", "settlement", "road", "city", "buy card", "year of plenty",
+                                  "monopoly", "road building", "trade", "sell knight", "buy knight", "end turn"};
+    string text = names[(size_t)action.type];
+    if (action.location >= 0)
+    {
+        text += " " + to_string(action.location);
+    }
+    return text;
+}
+
+/**
+ * Measures how fast the MCTS bot searches. Greedy bots play a game for a number of turns
+ * to reach a mid-game position, the next player rolls, and the bot then searches that
+ * position repeatedly. Prints the raw single-thread playout rate and the playouts per
+ * second of the full search on the requested threads.
+ */
+int main(int argc, char *argv[])
+{
+    uint64_t seed = 1;
+    int turns = 30;
+    MctsConfig config;
+    int searches = 5;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (i + 1 >= argc)
+        {
+            usage();
+        }
+        if (strcmp(argv[i], "--seed") == 0)
+        {
+            seed = strtoull(argv[++i], nullptr, 10);
+        }
+        else if (strcmp(argv[i], "--turns") == 0)
+        {
+            turns = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--ms") == 0)
+        {
+            config.timeLimitMs = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--iterations") == 0)
+        {
+            config.iterations = atol(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--threads") == 0)
+        {
+            config.threads = (unsigned)atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--searches") == 0)
+        {
+            searches = atoi(argv[++i]);
+        }
+        else
+        {
+            usage();
+        }
+    }
+
+    // Reach a mid-game position with greedy play
+    Player p1("Seat 1"), p2("Seat 2"), p3("Seat 3");
+    Catan game(p1, p2, p3, seed);
+    GreedyBot greedy;
+    vector<Bot *> bots = {&greedy, &greedy, &greedy};
+    Rng rng(~seed);
+    playSetup(game, bots, rng);
+    for (int turn = 0; turn < turns && !game.isGameEnded(); turn++)
+    {
+        playTurn(game, greedy, rng);
+    }
+    // Skip turns where ending the turn is the only move, which would not be searched
+    game.apply(Action::rollDice());
+    GameState root(game);
+    vector<Action> actions;
+    root.legalActions(actions);
+    while (actions.size() == 1 && !game.isGameEnded())
+    {
+        game.endTurn();
+        game.apply(Action::rollDice());
+        root = GameState(game);
+        root.legalActions(actions);
+    }
+
+    // Raw playout speed on one thread, without the tree
+    Rng playoutRng(seed);
+    long playouts = 0;
+    long playoutActions = 0;
+    auto start = chrono::steady_clock::now();
+    double seconds = 0;
+    while (seconds < 1.0)
+    {
+        for (int i = 0; i < 256; i++)
+        {
+            GameState state = root;
+            state.rng.reseed(playoutRng.next());
+            playoutActions += playout(state, playoutRng, config.playoutTurns);
+        }
+        playouts += 256;
+        seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    }
+
+    cout << fixed << setprecision(0);
+    cout << "Position:        seed " << seed << ", " << turns << " greedy turns, player " << (int)root.currentPlayer + 1 << " to move, "
+         << actions.size() << " moves" << endl;
+    cout << "Playouts/sec:    " << (double)playouts / seconds << " on 1 thread (" << config.playoutTurns << " turns, "
+         << (double)playoutActions / (double)playouts << " actions each)" << endl;
+
+    MctsBot bot(config);
+    long totalPlayouts = 0;
+    double totalSeconds = 0;
+    for (int i = 0; i < searches; i++)
+    {
+        Action action = bot.search(root, seed + (uint64_t)i);
+        const MctsStatistics &stats = bot.getStatistics();
+        totalPlayouts += stats.playouts;
+        totalSeconds += stats.seconds;
+        cout << "Search " << i + 1 << ":        " << describe(action) << ", " << stats.playouts << " playouts in "
+             << setprecision(3) << stats.seconds << "s" << setprecision(0) << endl;
+    }
+    if (totalSeconds > 0)
+    {
+        cout << "Search rate:     " << (double)totalPlayouts / totalSeconds << " playouts/sec" << endl;
+    }
+    return 0;
+}
@@ -0,0 +1,323 @@
+#include "metrics.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+namespace ariel
+{
+
+    static const char *const COUNTER_NAMES[] = {"settlements_placed", "cities_built", "roads_placed", "trades", "knights_traded",
+                                                "dice_rolled", "sevens_rolled", "cards_bought", "cards_played"};
+
+    const char *counterName(Counter counter)
+    {
+        return COUNTER_NAMES[(size_t)counter];
+    }
+
+    Histogram::Histogram() : total(0), sum(0), minimum(UINT64_MAX), maximum(0)
+    {
+        buckets.fill(0);
+    }
+
+    // Row 0 holds the values below SUB_BUCKETS one by one; row r holds
+    // [SUB_BUCKETS << (r - 1), SUB_BUCKETS << r) in buckets of width 1 << (r - 1)
+    size_t Histogram::bucketOf(uint64_t value)
+    {
+        if (value < SUB_BUCKETS)
+        {
+            return (size_t)value;
+        }
+        int exponent = 63 - __builtin_clzll(value);
+        if (exponent > MAX_EXPONENT)
+        {
+            return NUM_BUCKETS - 1;
+        }
+        int shift = exponent - SUB_BUCKET_BITS;
+        size_t row = (size_t)shift + 1;
+        return row * SUB_BUCKETS + (size_t)(value >> shift) - SUB_BUCKETS;
+    }
+
+    // Largest value that falls in a bucket
+    uint64_t Histogram::bucketTop(size_t bucket)
+    {
+        size_t row = bucket / SUB_BUCKETS;
+        uint64_t sub = bucket % SUB_BUCKETS;
+        if (row == 0)
+        {
+            return sub;
+        }
+        return ((SUB_BUCKETS + sub + 1) << (row - 1)) - 1;
+    }
+
+    void Histogram::record(uint64_t value)
+    {
+        buckets[bucketOf(value)]++;
+        total++;
+        sum += value;
+        minimum = std::min(minimum, value);
+        maximum = std::max(maximum, value);
+    }
+
+    void Histogram::merge(const Histogram &other)
+    {
+        for (size_t i = 0; i < NUM_BUCKETS; i++)
+        {
+            buckets[i] += other.buckets[i];
+        }
+        total += other.total;
+        sum += other.sum;
+        minimum = std::min(minimum, other.minimum);
+        maximum = std::max(maximum, other.maximum);
+    }
+
+    /**
+     * Finds a percentile of the recorded values.
+     *
+     * @param percent The share of values, from 0 to 100.
+     * @return The top of the bucket holding that value, capped at the largest value recorded; 0 if empty.
+     */
+    uint64_t Histogram::percentile(double percent) const
+    {
+        if (total == 0)
+        {
+            return 0;
+        }
+        uint64_t rank = (uint64_t)ceil(percent / 100.0 * (double)total);
+        rank = std::max<uint64_t>(1, std::min(rank, total));
+        uint64_t seen = 0;
+        for (size_t i = 0; i < NUM_BUCKETS; i++)
+        {
+            seen += buckets[i];
+            if (seen >= rank)
+            {
+                return std::min(bucketTop(i), maximum);
+            }
+        }
+        return maximum;
+    }
+
+    // The counters of one thread. Only the owning thread writes them, with plain
+    // relaxed loads and stores, so recording needs no locked instructions; readers
+    // may see a shard mid-update but never a torn value.
+    struct MetricsShard
+    {
+        array<atomic<uint64_t>, NUM_COUNTERS> counters;
+        array<atomic<uint64_t>, NUM_ACTION_TYPES> applied;
+        array<atomic<uint64_t>, NUM_ACTION_TYPES> rejected;
+        array<array<atomic<uint64_t>, Histogram::NUM_BUCKETS>, NUM_ACTION_TYPES> buckets;
+        array<atomic<uint64_t>, NUM_ACTION_TYPES> sums;
+        array<atomic<uint64_t>, NUM_ACTION_TYPES> minimums;
+        array<atomic<uint64_t>, NUM_ACTION_TYPES> maximums;
+
+        MetricsShard() { clear(); }
+
+        void clear()
+        {
+            for (auto &value : counters)
+            {
+                value.store(0);
+            }
+            for (size_t a = 0; a < NUM_ACTION_TYPES; a++)
+            {
+                applied[a].store(0);
+                rejected[a].store(0);
+                sums[a].store(0);
+                minimums[a].store(UINT64_MAX);
+                maximums[a].store(0);
+                for (auto &bucket : buckets[a])
+                {
+                    bucket.store(0);
+                }
+            }
+        }
+    };
+
+    // Adds to a value that only the calling thread writes
+    static inline void bump(atomic<uint64_t> &value, uint64_t amount = 1)
+    {
+        value.store(value.load(memory_order_relaxed) + amount, memory_order_relaxed);
+    }
+
+    // Every shard ever created; shards outlive their threads so nothing recorded is lost
+    static vector<unique_ptr<MetricsShard>> &shards()
+    {
+        static vector<unique_ptr<MetricsShard>> all;
+        return all;
+    }
+
+    static mutex &shardLock()
+    {
+        static mutex lock;
+        return lock;
+    }
+
+    static MetricsShard &localShard()
+    {
+        static thread_local MetricsShard *shard = nullptr;
+        if (!shard)
+        {
+            lock_guard<mutex> guard(shardLock());
+            shards().emplace_back(new MetricsShard());
+            shard = shards().back().get();
+        }
+        return *shard;
+    }
+
+    atomic<bool> Metrics::enabled(false);
+
+    void Metrics::setEnabled(bool on)
+    {
+        enabled.store(on);
+    }
+
+    /**
+     * Records an action applied to a game in the calling thread's shard.
+     *
+     * @param action The action.
+     * @param result What the engine answered.
+     * @param nanoseconds How long the engine took.
+     * @param roll The dice result after the action, to count sevens.
+     */
+    void Metrics::recordAction(const Action &action, ActionResult result, uint64_t nanoseconds, int roll)
+    {
+        MetricsShard &shard = localShard();
+        size_t type = (size_t)action.type;
+        bump(shard.buckets[type][Histogram::bucketOf(nanoseconds)]);
+        bump(shard.sums[type], nanoseconds);
+        if (nanoseconds < shard.minimums[type].load(memory_order_relaxed))
+        {
+            shard.minimums[type].store(nanoseconds, memory_order_relaxed);
+        }
+        if (nanoseconds > shard.maximums[type].load(memory_order_relaxed))
+        {
+            shard.maximums[type].store(nanoseconds, memory_order_relaxed);
+        }
+        if (result != ActionResult::Success)
+        {
+            bump(shard.rejected[type]);
+            return;
+        }
+        bump(shard.applied[type]);
+
+        switch (action.type)
+        {
+        case ActionType::RollDice:
+            bump(shard.counters[(size_t)Counter::DiceRolled]);
+            if (roll == 7)
+            {
+                bump(shard.counters[(size_t)Counter::SevensRolled]);
+            }
+            break;
+        case ActionType::PlaceSettlement:
+            bump(shard.counters[(size_t)Counter::SettlementsPlaced]);
+            break;
+        case ActionType::PlaceRoad:
+            bump(shard.counters[(size_t)Counter::RoadsPlaced]);
+            break;
+        case ActionType::UpgradeSettlement:
+            bump(shard.counters[(size_t)Counter::CitiesBuilt]);
+            break;
+        case ActionType::BuyDevelopmentCard:
+            bump(shard.counters[(size_t)Counter::CardsBought]);
+            break;
+        case ActionType::PlayRoadBuilding:
+            bump(shard.counters[(size_t)Counter::RoadsPlaced], 2);
+            bump(shard.counters[(size_t)Counter::CardsPlayed]);
+            break;
+        case ActionType::PlayYearOfPlenty:
+        case ActionType::PlayMonopoly:
+            bump(shard.counters[(size_t)Counter::CardsPlayed]);
+            break;
+        case ActionType::TradeResources:
+            bump(shard.counters[(size_t)Counter::Trades]);
+            break;
+        case ActionType::SellKnight:
+        case ActionType::BuyKnight:
+            bump(shard.counters[(size_t)Counter::KnightsTraded], (uint64_t)action.knights);
+            break;
+        case ActionType::EndTurn:
+            break;
+        }
+    }
+
+    // Merges every shard
+    MetricsSnapshot Metrics::snapshot()
+    {
+        MetricsSnapshot merged;
+        merged.counters.fill(0);
+        merged.applied.fill(0);
+        merged.rejected.fill(0);
+
+        lock_guard<mutex> guard(shardLock());
+        for (const auto &shard : shards())
+        {
+            for (size_t c = 0; c < NUM_COUNTERS; c++)
+            {
+                merged.counters[c] += shard->counters[c].load(memory_order_relaxed);
+            }
+            for (size_t a = 0; a < NUM_ACTION_TYPES; a++)
+            {
+                merged.applied[a] += shard->applied[a].load(memory_order_relaxed);
+                merged.rejected[a] += shard->rejected[a].load(memory_order_relaxed);
+
+                Histogram &latency = merged.latency[a];
+                for (size_t b = 0; b < Histogram::NUM_BUCKETS; b++)
+                {
+                    uint64_t count = shard->buckets[a][b].load(memory_order_relaxed);
+                    latency.buckets[b] += count;
+                    latency.total += count;
+                }
+                latency.sum += shard->sums[a].load(memory_order_relaxed);
+                latency.minimum = std::min(latency.minimum, shard->minimums[a].load(memory_order_relaxed));
+                latency.maximum = std::max(latency.maximum, shard->maximums[a].load(memory_order_relaxed));
+            }
+        }
+        return merged;
+    }
+
+    void Metrics::reset()
+    {
+        lock_guard<mutex> guard(shardLock());
+        for (const auto &shard : shards())
+        {
+            shard->clear();
+        }
+    }
+
+    /**
+     * Formats the counters and, for every action type that was applied, how often it
+     * succeeded or was rejected and its latency percentiles in nanoseconds.
+     *
+     * @param snapshot The metrics to format.
+     * @return A table, one line per counter and per action type.
+     */
+    string Metrics::report(const MetricsSnapshot &snapshot)
+    {
+        ostringstream out;
+        out << "Counters:" << '\n';
+        for (size_t c = 0; c < NUM_COUNTERS; c++)
+        {
+            out << "  " << left << setw(20) << COUNTER_NAMES[c] << right << setw(12) << snapshot.counters[c] << '\n';
+        }
+        out << "Latency per action (ns):" << '\n';
+        out << "  " << left << setw(20) << "action" << right << setw(12) << "applied" << setw(12) << "rejected"
+            << setw(10) << "p50" << setw(10) << "p99" << setw(10) << "p99.9" << setw(12) << "max" << '\n';
+        for (size_t a = 0; a < NUM_ACTION_TYPES; a++)
+        {
+            const Histogram &latency = snapshot.latency[a];
+            if (latency.count() == 0)
+            {
+                continue;
+            }
+            out << "  " << left << setw(20) << actionName((ActionType)a) << right << setw(12) << snapshot.applied[a]
+                << setw(12) << snapshot.rejected[a] << setw(10) << latency.percentile(50) << setw(10) << latency.percentile(99)
+                << setw(10) << latency.percentile(99.9) << setw(12) << latency.max() << '\n';
+        }
+        return out.str();
+    }
+}
@@ -0,0 +1,112 @@
+#ifndef METRICS_HPP
+#define METRICS_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "action.hpp"
+
+using namespace std;
+
+namespace ariel
+{
+
+    // Events counted by the engine
+    enum class Counter
+    {
+        SettlementsPlaced,
+        CitiesBuilt,
+        RoadsPlaced,
+        Trades,
+        KnightsTraded,
+        DiceRolled,
+        SevensRolled,
+        CardsBought,
+        CardsPlayed
+    };
+    const size_t NUM_COUNTERS = 9;
+
+    // Name of a counter, like "settlements_placed"
+    const char *counterName(Counter counter);
+
+    // A log-linear histogram in the style of HdrHistogram: every power of two is split
+    // into SUB_BUCKETS equal buckets, so any recorded value is known to within 1/16
+    // of itself, up to 2^(MAX_EXPONENT + 1). Larger values land in the last bucket.
+    class Histogram
+    {
+        friend class Metrics;
+
+    public:
+        static const int SUB_BUCKET_BITS = 4;
+        static const size_t SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+        static const int MAX_EXPONENT = 40;
+        static const size_t NUM_BUCKETS = (MAX_EXPONENT - SUB_BUCKET_BITS + 2) * SUB_BUCKETS;
+
+        Histogram();
+
+        void record(uint64_t value);
+
+        // Adds the counts of another histogram
+        void merge(const Histogram &other);
+
+        uint64_t count() const { return total; }
+        uint64_t min() const { return total ? minimum : 0; }
+        uint64_t max() const { return maximum; }
+        double mean() const { return total ? (double)sum / (double)total : 0.0; }
+
+        // The value below which the given share of the recorded values fall, like
+        // percentile(99) for the p99; it is the upper end of the bucket holding it
+        uint64_t percentile(double percent) const;
+
+    private:
+        array<uint64_t, NUM_BUCKETS> buckets;
+        uint64_t total;
+        uint64_t sum;
+        uint64_t minimum;
+        uint64_t maximum;
+
+        static size_t bucketOf(uint64_t value);
+        static uint64_t bucketTop(size_t bucket);
+    };
+
+    // Everything recorded so far, merged from every thread
+    struct MetricsSnapshot
+    {
+        array<uint64_t, NUM_COUNTERS> counters;
+        array<uint64_t, NUM_ACTION_TYPES> applied;  // Successful actions by type
+        array<uint64_t, NUM_ACTION_TYPES> rejected; // Rejected actions by type
+        array<Histogram, NUM_ACTION_TYPES> latency; // Nanoseconds per action, by type
+
+        uint64_t counter(Counter counter) const { return counters[(size_t)counter]; }
+    };
+
+    // Process-wide engine metrics: counters and latency histograms per action type.
+    // Every thread records into its own shard without locking, and reading merges
+    // the shards. Recording is off by default, so games pay only for one check per
+    // action; turn it on with setEnabled.
+    class Metrics
+    {
+    private:
+        static atomic<bool> enabled;
+
+    public:
+        static void setEnabled(bool on);
+        static bool isEnabled() { return enabled.load(memory_order_relaxed); }
+
+        // Records one applied action: its result, its latency and the events it caused
+        static void recordAction(const Action &action, ActionResult result, uint64_t nanoseconds, int roll);
+
+        static MetricsSnapshot snapshot();
+
+        // Zeroes every shard; call it while no thread is recording
+        static void reset();
+
+        // A table of the counters and of the latency percentiles per action type
+        static string report(const MetricsSnapshot &snapshot);
+    };
+}
+
+#endif
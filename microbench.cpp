@@ -0,0 +1,406 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <functional>
+
+#include "simulation.hpp"
+#include "alloctrack.hpp"
+#include "evaluator.hpp"
+#include "snapshot.hpp"
+
+using namespace std;
+using namespace ariel;
+
+// Results are folded into this so the compiler cannot drop the measured work
+static volatile long sink = 0;
+
+// Measured cost of one benchmark: the median of the trials
+struct BenchResult
+{
+    string name;
+    long opsPerTrial;
+    int trials;
+    double nsPerOp;
+    double opsPerSec;
+    double allocsPerOp;
+};
+
+// A benchmark runs a batch of operations and returns how many it performed
+typedef function<long(long)> BenchBody;
+
+void usage()
+{
+    cerr << "Usage: microbench [--format text|json|csv] [--trials N] [--ms M] [--filter NAME]" << endl;
+    exit(1);
+}
+
+/**
+ * Times a benchmark. The batch size is first doubled until a batch takes about the
+ * trial time, which also serves as the warmup; then every trial runs one batch.
+ *
+ * @param name The name of the benchmark.
+ * @param body Runs a batch of the requested size and returns the operations done.
+ * @param trials The number of timed batches.
+ * @param trialMs The target duration of one batch.
+ * @return The median time per operation and the allocations per operation.
+ */
+BenchResult measure(const string &name, const BenchBody &body, int trials, double trialMs)
+{
+    typedef chrono::steady_clock Clock;
+    long batch = 1;
+    while (true)
+    {
+        auto start = Clock::now();
+        body(batch);
+        double ms = chrono::duration<double, milli>(Clock::now() - start).count();
+        if (ms >= trialMs || batch >= (1L << 30))
+        {
+            break;
+        }
+        batch *= ms < trialMs / 16 ? 8 : 2;
+    }
+
+    vector<double> nsPerOp;
+    long ops = 0;
+    long allocated = 0;
+    for (int t = 0; t < trials; t++)
+    {
+        long before = AllocationTracker::threadAllocations();
+        auto start = Clock::now();
+        long done = body(batch);
+        double ns = chrono::duration<double, nano>(Clock::now() - start).count();
+        allocated += AllocationTracker::threadAllocations() - before;
+        ops += done;
+        nsPerOp.push_back(ns / (double)max(done, 1L));
+    }
+    sort(nsPerOp.begin(), nsPerOp.end());
+
+    BenchResult result;
+    result.name = name;
+    result.opsPerTrial = ops / trials;
+    result.trials = trials;
+    result.nsPerOp = nsPerOp[nsPerOp.size() / 2];
+    result.opsPerSec = result.nsPerOp > 0 ? 1e9 / result.nsPerOp : 0.0;
+    result.allocsPerOp = (double)allocated / (double)max(ops, 1L);
+    return result;
+}
+
+// Vertices that can all hold a settlement at once, picked greedily from vertex 0
+vector<int> spreadVertices(Board &board, size_t count)
+{
+    vector<int> chosen;
+    for (int v = 0; v < board.getVerticesSize() && chosen.size() < count; v++)
+    {
+        bool free = true;
+        for (int other : chosen)
+        {
+            const IdList<3> &neighbors = board.getVertexNeighbors(v);
+            if (other == v || find(neighbors.begin(), neighbors.end(), other) != neighbors.end())
+            {
+                free = false;
+            }
+        }
+        if (free)
+        {
+            chosen.push_back(v);
+        }
+    }
+    return chosen;
+}
+
+// Every edge, ordered so that each one touches a vertex reached before it
+vector<int> edgesFrom(Board &board, int vertexId)
+{
+    vector<int> order;
+    vector<bool> seenVertex((size_t)board.getVerticesSize(), false), seenEdge((size_t)board.getEdgesSize(), false);
+    vector<int> queue = {vertexId};
+    seenVertex[(size_t)vertexId] = true;
+    for (size_t i = 0; i < queue.size(); i++)
+    {
+        for (int e : board.getVertexEdges(queue[i]))
+        {
+            if (seenEdge[(size_t)e])
+            {
+                continue;
+            }
+            seenEdge[(size_t)e] = true;
+            order.push_back(e);
+            for (int v : board.getEdgeVertices(e))
+            {
+                if (!seenVertex[(size_t)v])
+                {
+                    seenVertex[(size_t)v] = true;
+                    queue.push_back(v);
+                }
+            }
+        }
+    }
+    return order;
+}
+
+/**
+ * Microbenchmarks of the engine's hot paths. Each benchmark reports the median
+ * nanoseconds per operation over several trials, the matching operations per
+ * second and the heap allocations per operation, as text, JSON or CSV. In the
+ * instrumentation build (make TRACK_ALLOCATIONS=1) the text output ends with the
+ * allocations of every engine entry point over the whole run.
+ */
+int main(int argc, char *argv[])
+{
+    string format = "text";
+    int trials = 5;
+    double trialMs = 50;
+    string filter;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (i + 1 >= argc)
+        {
+            usage();
+        }
+        if (strcmp(argv[i], "--format") == 0)
+        {
+            format = argv[++i];
+        }
+        else if (strcmp(argv[i], "--trials") == 0)
+        {
+            trials = max(1, atoi(argv[++i]));
+        }
+        else if (strcmp(argv[i], "--ms") == 0)
+        {
+            trialMs = atof(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--filter") == 0)
+        {
+            filter = argv[++i];
+        }
+        else
+        {
+            usage();
+        }
+    }
+    if (format != "text" && format != "json" && format != "csv")
+    {
+        usage();
+    }
+
+    Rng rng(1);
+    Board board(rng);
+    Player alice("Alice", 0), bob("Bob", 1), charlie("Charlie", 2);
+    vector<Player *> seats = {&alice, &bob, &charlie};
+    vector<int> spots = spreadVertices(board, 9);
+    vector<int> edges = edgesFrom(board, 0);
+
+    // A board with three settlements per player, for production and validation
+    Board settled(rng);
+    for (size_t i = 0; i < spots.size(); i++)
+    {
+        settled.placeSettlement(spots[i], *seats[i % seats.size()], true);
+    }
+
+    // A game past the setup, for dice rolls
+    Player p1("Alice"), p2("Bob"), p3("Charlie");
+    Catan game(p1, p2, p3, 1);
+    for (size_t i = 0; i < 6; i++)
+    {
+        game.apply(Action::placeSettlement(spots[i]));
+        game.nextPlayer();
+    }
+
+    vector<pair<string, BenchBody>> benchmarks;
+    benchmarks.push_back({"board_construct", [&](long n) {
+                              for (long i = 0; i < n; i++)
+                              {
+                                  Board fresh(rng);
+                                  sink += fresh.getTile(0).number;
+                              }
+                              return n;
+                          }});
+    benchmarks.push_back({"give_resources", [&](long n) {
+                              for (long i = 0; i < n; i++)
+                              {
+                                  settled.giveResources(*seats[(size_t)i % seats.size()], 2 + (int)(i % 11));
+                              }
+                              sink += alice.getTotalResources();
+                              return n;
+                          }});
+    benchmarks.push_back({"roll_dice", [&](long n) {
+                              for (long i = 0; i < n; i++)
+                              {
+                                  game.rollDice(game.getBoard());
+                              }
+                              sink += game.getLastRoll();
+                              return n;
+                          }});
+    // Fills the board with settlements, then clears it; the clearing is part of the cost
+    benchmarks.push_back({"place_settlement", [&](long n) {
+                              long done = 0;
+                              while (done < n)
+                              {
+                                  board.clearPieces();
+                                  for (size_t i = 0; i < spots.size(); i++, done++)
+                                  {
+                                      sink += board.placeSettlement(spots[i], *seats[i % seats.size()], true);
+                                  }
+                              }
+                              return done;
+                          }});
+    // Builds a player's whole supply of roads outward from one settlement, then clears the board
+    benchmarks.push_back({"place_road", [&](long n) {
+                              long done = 0;
+                              while (done < n)
+                              {
+                                  board.clearPieces();
+                                  board.placeSettlement(0, alice, true);
+                                  for (size_t i = 0; i < (size_t)MAX_ROADS; i++, done++)
+                                  {
+                                      sink += board.placeRoad(edges[i], alice);
+                                  }
+                              }
+                              return done;
+                          }});
+    benchmarks.push_back({"is_valid_settlement", [&](long n) {
+                              long valid = 0;
+                              for (long i = 0; i < n; i++)
+                              {
+                                  valid += settled.isValidSettlementLocation((int)(i % NUM_VERTICES));
+                              }
+                              sink += valid;
+                              return n;
+                          }});
+    // Refills the hand to 16 cards before each discard
+    benchmarks.push_back({"its_seven", [&](long n) {
+                              Player player("Dan");
+                              for (long i = 0; i < n; i++)
+                              {
+                                  for (size_t r = 0; r < NUM_RESOURCES; r++)
+                                  {
+                                      player.addResource((Resource)r, 4 - player.amountOfResources((Resource)r) % 4);
+                                  }
+                                  player.itsSeven(rng);
+                              }
+                              sink += player.getTotalResources();
+                              return n;
+                          }});
+    benchmarks.push_back({"has_enough_resources", [&](long n) {
+                              long enough = 0;
+                              for (long i = 0; i < n; i++)
+                              {
+                                  enough += seats[(size_t)i % seats.size()]->hasEnoughResources((Purchase)((size_t)i % NUM_PURCHASES));
+                              }
+                              sink += enough;
+                              return n;
+                          }});
+    // Generates the topology of a board with 91 tiles, bypassing the shape cache
+    vector<HexCoord> largeShape = HexTopology::hexagonShape(5);
+    benchmarks.push_back({"generate_topology", [&](long n) {
+                              for (long i = 0; i < n; i++)
+                              {
+                                  HexTopology topology(largeShape);
+                                  sink += topology.numEdges();
+                              }
+                              return n;
+                          }});
+    // Scores the whole board from its tiles
+    benchmarks.push_back({"evaluator_construct", [&](long n) {
+                              for (long i = 0; i < n; i++)
+                              {
+                                  VertexEvaluator evaluator(settled);
+                                  sink += (long)evaluator.score((int)(i % NUM_VERTICES));
+                              }
+                              return n;
+                          }});
+    // Plans both setup settlements on an empty board
+    VertexEvaluator evaluator(board);
+    VertexMask open = Board(rng).getLegalSettlements(0, true);
+    benchmarks.push_back({"best_setup_pair", [&](long n) {
+                              for (long i = 0; i < n; i++)
+                              {
+                                  sink += evaluator.bestPair(open).first;
+                              }
+                              return n;
+                          }});
+    // Opens a file of 10000 saved positions and reads one of them
+    const string snapshotPath = "microbench_snapshot.bin";
+    saveSnapshots(snapshotPath, vector<GameState>(10000, GameState(game)));
+    benchmarks.push_back({"open_snapshot", [&](long n) {
+                              for (long i = 0; i < n; i++)
+                              {
+                                  SnapshotFile file(snapshotPath);
+                                  sink += file[(size_t)i % file.size()].currentPlayer;
+                              }
+                              return n;
+                          }});
+    benchmarks.push_back({"random_game", [&](long n) {
+                              RandomBot first, second, third;
+                              vector<Bot *> bots = {&first, &second, &third};
+                              for (long i = 0; i < n; i++)
+                              {
+                                  sink += playGame(bots, (uint64_t)i, 500).turns;
+                              }
+                              return n;
+                          }});
+
+    vector<BenchResult> results;
+    for (const auto &benchmark : benchmarks)
+    {
+        if (filter.empty() || benchmark.first.find(filter) != string::npos)
+        {
+            results.push_back(measure(benchmark.first, benchmark.second, trials, trialMs));
+        }
+    }
+    remove(snapshotPath.c_str());
+
+    cout << fixed;
+    if (format == "json")
+    {
+        cout << "[" << endl;
+        for (size_t i = 0; i < results.size(); i++)
+        {
+            const BenchResult &r = results[i];
+            cout << setprecision(2) << "  {\"name\": \"" << r.name << "\", \"ns_per_op\": " << r.nsPerOp
+                 << ", \"ops_per_sec\": " << setprecision(0) << r.opsPerSec
+                 << ", \"allocs_per_op\": " << setprecision(3) << r.allocsPerOp
+                 << ", \"ops_per_trial\": " << r.opsPerTrial << ", \"trials\": " << r.trials << "}"
+                 << (i + 1 < results.size() ? "," : "") << endl;
+        }
+        cout << "]" << endl;
+    }
+    else if (format == "csv")
+    {
+        cout << "name,ns_per_op,ops_per_sec,allocs_per_op,ops_per_trial,trials" << endl;
+        for (const BenchResult &r : results)
+        {
+            cout << r.name << "," << setprecision(2) << r.nsPerOp << "," << setprecision(0) << r.opsPerSec << ","
+                 << setprecision(3) << r.allocsPerOp << "," << r.opsPerTrial << "," << r.trials << endl;
+        }
+    }
+    else
+    {
+        cout << left << setw(22) << "Benchmark" << right << setw(14) << "ns/op" << setw(16) << "ops/sec" << setw(14) << "allocs/op" << endl;
+        for (const BenchResult &r : results)
+        {
+            cout << left << setw(22) << r.name << right << setprecision(2) << setw(14) << r.nsPerOp
+                 << setprecision(0) << setw(16) << r.opsPerSec << setprecision(3) << setw(14) << r.allocsPerOp << endl;
+        }
+
+        vector<pair<string, AllocationStats>> sites = AllocationTracker::sites();
+        if (!sites.empty())
+        {
+            cout << endl
+                 << left << setw(32) << "Allocation site" << right << setw(14) << "allocs" << setw(16) << "bytes" << setw(14) << "peak bytes" << endl;
+            for (const auto &site : sites)
+            {
+                cout << left << setw(32) << site.first << right << setw(14) << site.second.allocations
+                     << setw(16) << site.second.bytes << setw(14) << site.second.peakBytes << endl;
+            }
+        }
+    }
+    return 0;
+}
@@ -1,41 +1,136 @@
 #include "player.hpp"
+#include "journal.hpp"
+#include "log.hpp"
 
 using namespace std;
 
 namespace ariel
 {
+    // Names used by the user interface, indexed by the matching enum
+    static const string RESOURCE_NAMES[NUM_RESOURCES] = {"brick", "grain", "lumber", "ore", "wool"};
+    static const string DEV_CARD_NAMES[NUM_DEV_CARDS] = {"knight", "monopoly", "road building", "victory point", "year of plenty"};
+    static const string PURCHASE_NAMES[NUM_PURCHASES] = {"settlement", "city", "road", "development card"};
+
+    // Resources needed for every purchase, indexed by Purchase and then by Resource
+    static const int COSTS[NUM_PURCHASES][NUM_RESOURCES] = {
+        // brick, grain, lumber, ore, wool
+        {1, 1, 1, 0, 1}, // Settlement
+        {0, 2, 0, 3, 0}, // City
+        {1, 0, 1, 0, 0}, // Road
+        {0, 1, 0, 1, 1}  // Development card
+    };
+
+    const int *purchaseCost(Purchase purchase)
+    {
+        return COSTS[(size_t)purchase];
+    }
+
+    const string &resourceName(Resource resource)
+    {
+        return RESOURCE_NAMES[(size_t)resource];
+    }
+
+    const string &devCardName(DevCard card)
+    {
+        return DEV_CARD_NAMES[(size_t)card];
+    }
+
+    /**
+     * Converts a resource name to its Resource value.
+     *
+     * @param name The name of the resource, e.g. "wool".
+     * @param resource Set to the matching resource if the name is known.
+     * @return True if the name is a resource, false otherwise.
+     */
+    bool parseResource(const string &name, Resource &resource)
+    {
+        for (size_t i = 0; i < NUM_RESOURCES; i++)
+        {
+            if (RESOURCE_NAMES[i] == name)
+            {
+                resource = (Resource)i;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * Converts a development card name to its DevCard value.
+     *
+     * @param name The name of the card, e.g. "knight".
+     * @param card Set to the matching card if the name is known.
+     * @return True if the name is a development card, false otherwise.
+     */
+    bool parseDevCard(const string &name, DevCard &card)
+    {
+        for (size_t i = 0; i < NUM_DEV_CARDS; i++)
+        {
+            if (DEV_CARD_NAMES[i] == name)
+            {
+                card = (DevCard)i;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * Converts a purchase name to its Purchase value.
+     *
+     * @param name The name of the purchase, e.g. "settlement".
+     * @param purchase Set to the matching purchase if the name is known.
+     * @return True if the name is a purchase, false otherwise.
+     */
+    bool parsePurchase(const string &name, Purchase &purchase)
+    {
+        for (size_t i = 0; i < NUM_PURCHASES; i++)
+        {
+            if (PURCHASE_NAMES[i] == name)
+            {
+                purchase = (Purchase)i;
+                return true;
+            }
+        }
+        return false;
+    }
+
     /**
      * Player constructor.
      *
      * @param name The name of the player.
+     * @param id The index of the player, used to mark ownership on the board.
      */
-    Player::Player(const string &name) : name(name)
+    Player::Player(const string &name, uint8_t id) : name(name), id(id), journal(nullptr)
     {
         // Initialize resources.
-        // For each resource, set the initial amount.
-        resources = {
-            {"wool", 0},   // Wool has an initial amount of 0.
-            {"brick", 2},  // Brick has an initial amount of 2.
-            {"grain", 0},  // Grain has an initial amount of 0.
-            {"lumber", 2}, // Lumber has an initial amount of 2.
-            {"ore", 0}     // Ore has an initial amount of 0.
-        };
+        // Every player starts with 2 brick and 2 lumber, enough for the first two roads.
+        resources.fill(0);
+        resources[(size_t)Resource::Brick] = 2;
+        resources[(size_t)Resource::Lumber] = 2;
 
         // Initialize development cards.
-        // For each development card, set the initial amount.
-        devCards = {
-            {"knight", 0},         // Knight card has an initial amount of 0.
-            {"victory point", 0},  // Victory point card has an initial amount of 0.
-            {"year of plenty", 0}, // Year of plenty card has an initial amount of 0.
-            {"monopoly", 0},       // Monopoly card has an initial amount of 0.
-            {"road building", 0}   // Road building card has an initial amount of 0.
-        };
+        devCards.fill(0);
 
         // Initialize other variables.
         points = 0;           // Start with no points.
         sumeOfResources = 4;  // Start with 4 resources.
         numOfSettlements = 0; // Start with no settlements.
         numOfCities = 0;      // Start with no cities.
+        longestRoad = false;  // Nobody starts with the Longest Road card.
+        rehash();
+    }
+
+    /**
+     * Checks if a string names one of the five resources.
+     *
+     * @param type The string to check.
+     * @return True for wool, brick, grain, lumber and ore, false otherwise.
+     */
+    bool Player::isResource(const string &type)
+    {
+        Resource resource;
+        return parseResource(type, resource);
     }
 
     const string &Player::getName() const
@@ -43,19 +138,96 @@ namespace ariel
         return name;
     }
 
+    uint8_t Player::getId() const
+    {
+        return id;
+    }
+
+    void Player::setId(uint8_t id)
+    {
+        this->id = id;
+
+        // The keys depend on the ID
+        rehash();
+    }
+
+    /**
+     * Changes the amount of a resource, keeping the hash in step.
+     *
+     * @param resource The index of the resource.
+     * @param amount The amount to add, negative to remove.
+     */
+    void Player::changeResource(size_t resource, int amount)
+    {
+        hash ^= zobrist::resource(id, resource, resources[resource]);
+        resources[resource] += amount;
+        hash ^= zobrist::resource(id, resource, resources[resource]);
+        sumeOfResources += amount;
+        if (journal && journal->isRecording())
+        {
+            journal->add({ChangeKind::Resource, id, (uint8_t)resource, amount, {}, {}});
+        }
+    }
+
+    /**
+     * Changes the number of development cards of a type, keeping the hash in step.
+     *
+     * @param card The index of the card type.
+     * @param amount The number of cards to add, negative to remove.
+     */
+    void Player::changeDevelopmentCard(size_t card, int amount)
+    {
+        hash ^= zobrist::devCard(id, card, devCards[card]);
+        devCards[card] += amount;
+        hash ^= zobrist::devCard(id, card, devCards[card]);
+        if (journal && journal->isRecording())
+        {
+            journal->add({ChangeKind::DevCard, id, (uint8_t)card, amount, {}, {}});
+        }
+    }
+
+    /**
+     * Recomputes the hash from the resources and development cards.
+     */
+    void Player::rehash()
+    {
+        hash = 0;
+        for (size_t r = 0; r < NUM_RESOURCES; r++)
+        {
+            hash ^= zobrist::resource(id, r, resources[r]);
+        }
+        for (size_t c = 0; c < NUM_DEV_CARDS; c++)
+        {
+            hash ^= zobrist::devCard(id, c, devCards[c]);
+        }
+    }
+
     /**
      * Adds a specified amount of a resource to the player's resources.
      *
+     * @param resource The resource to add.
+     * @param amount The amount of the resource to add.
+     */
+    void Player::addResource(Resource resource, int amount)
+    {
+        // Increase the amount of the specified resource and the total by the given amount.
+        changeResource((size_t)resource, amount);
+    }
+
+    /**
+     * Adds a specified amount of a resource to the player's resources.
+     * Unknown resource names are ignored.
+     *
      * @param resource The name of the resource to add.
      * @param amount The amount of the resource to add.
      */
     void Player::addResource(const string &resource, int amount)
     {
-        // Increase the amount of the specified resource by the given amount.
-        resources[resource] += amount;
-
-        // Increase the total amount of resources by the given amount.
-        sumeOfResources += amount;
+        Resource type;
+        if (parseResource(resource, type))
+        {
+            addResource(type, amount);
+        }
     }
 
     /**
@@ -66,57 +238,41 @@ namespace ariel
      * @param receiveResource The resource being received.
      * @param giveAmount The amount of the giving resource being traded.
      * @param receiveAmount The amount of the receiving resource being traded.
+     * @return True if the trade was completed, false otherwise.
      */
-    void Player::trade(Player &other, const string &giveResource, const string &receiveResource, int giveAmount, int receiveAmount)
+    bool Player::trade(Player &other, Resource giveResource, Resource receiveResource, int giveAmount, int receiveAmount)
     {
         // Check if the resources being traded are the same.
         if (giveResource == receiveResource)
         {
-            cout << "Cannot trade resources of the same type." << endl;
-            return;
+            return false;
         }
 
         // Check if the trade amounts are valid.
         if (giveAmount <= 0 || receiveAmount <= 0)
         {
-            cout << "Invalid trade amount." << endl;
-            return;
+            return false;
         }
 
         // Check if the trader has enough resources to complete the trade.
-        if (giveAmount > resources[giveResource] || receiveAmount > other.resources[receiveResource])
+        if (!haveResources(giveResource, giveAmount) || !other.haveResources(receiveResource, receiveAmount))
         {
-            cout << "Insufficient resources to complete trade." << endl;
-            return;
+            return false;
         }
 
-        // Deduct resources from both players.
-        if (resources[giveResource] >= giveAmount && other.resources[receiveResource] >= receiveAmount)
-        {
-            resources[giveResource] -= giveAmount;
-            other.resources[giveResource] += giveAmount;
-            resources[receiveResource] += receiveAmount;
-            other.resources[receiveResource] -= receiveAmount;
-
-            // Update the total amount of resources.
-            sumeOfResources -= giveAmount;
-            other.sumeOfResources -= receiveAmount;
-            cout << "Trade completed successfully." << endl;
-            cout << "your updated resources: " << endl;
-            printResources();
-        }
-        else
-        {
-            cout << "Trade cannot be completed due to insufficient resources." << endl;
-        }
+        // Move the resources between both players.
+        deductResources(giveResource, giveAmount);
+        other.addResource(giveResource, giveAmount);
+        addResource(receiveResource, receiveAmount);
+        other.deductResources(receiveResource, receiveAmount);
+        return true;
     }
 
-
     /**
      * Calculates and returns the total number of points for the player.
      *
      * The calculation is based on the number of settlements, cities, the presence of
-     * three knights, and the existence of a Victory Point card.
+     * three knights, the existence of a Victory Point card and the Longest Road card.
      *
      * @return The total number of points for the player.
      */
@@ -138,80 +294,67 @@ namespace ariel
         // Check if the player has a Victory Point card and add the result to the sum of points
         sumOfPoints += amountOfVictoryPoint();
 
+        // The Longest Road card is worth two points
+        if (longestRoad)
+            sumOfPoints += 2;
+
         return sumOfPoints;
     }
 
     /**
-     * Checks if the player has enough resources to purchase a specific type.
+     * Checks if the player has enough resources to pay for a purchase.
      *
-     * @param type The type of resource to check.
+     * @param purchase The thing to pay for.
      * @return True if the player has enough resources, false otherwise.
      */
-    bool Player::hasEnoughResources(const string &type)
+    bool Player::hasEnoughResources(Purchase purchase) const
     {
-        // Check resource type and return false if any resource is insufficient
-        if (type == "settlement")
-        {
-            if (resources["wool"] < 1 || resources["brick"] < 1 || resources["grain"] < 1 || resources["lumber"] < 1)
-            {
-                return false;
-            }
-        }
-        else if (type == "city")
-        {
-            if (resources["ore"] < 3 || resources["grain"] < 2)
-            {
-                return false;
-            }
-        }
-        else if (type == "road")
-        {
-            if (resources["lumber"] < 1 || resources["brick"] < 1)
-            {
-                return false;
-            }
-        }
-        else if (type == "development card")
-        {
-            if (resources["ore"] < 1 || resources["grain"] < 1 || resources["wool"] < 1)
-            {
-                return false;
-            }
-        }
-        else if (type == "knight")
-        {
-            if (devCards["knight"] < 1)
-            {
-                return false;
-            }
-        }
-        else if (type == "year of plenty")
+        const int *cost = COSTS[(size_t)purchase];
+        for (size_t i = 0; i < NUM_RESOURCES; i++)
         {
-            if (devCards["year of plenty"] < 1)
+            if (resources[i] < cost[i])
             {
                 return false;
             }
         }
-        else if (type == "monopoly")
+        return true;
+    }
+
+    /**
+     * Checks if the player has enough resources to purchase a specific type,
+     * or holds the named development card.
+     *
+     * @param type The name of a purchase (settlement, city, road, development card)
+     *             or of a development card.
+     * @return True if the player has enough resources, false otherwise.
+     */
+    bool Player::hasEnoughResources(const string &type)
+    {
+        Purchase purchase;
+        DevCard card;
+        if (parsePurchase(type, purchase))
         {
-            if (devCards["monopoly"] < 1)
-            {
-                return false;
-            }
+            return hasEnoughResources(purchase);
         }
-        else if (type == "road building")
+        if (parseDevCard(type, card))
         {
-            if (devCards["road building"] < 1)
-            {
-                return false;
-            }
+            return hasDevelopmentCard(card);
         }
-        else
+        return false; // Handle unknown type
+    }
+
+    /**
+     * Deducts the cost of a purchase from the player's resources.
+     *
+     * @param purchase The thing being paid for.
+     */
+    void Player::deductResources(Purchase purchase)
+    {
+        const int *cost = COSTS[(size_t)purchase];
+        for (size_t i = 0; i < NUM_RESOURCES; i++)
         {
-            return false; // Handle unknown type
+            changeResource(i, -cost[i]);
         }
-
-        return true;
     }
 
     /**
@@ -225,109 +368,48 @@ namespace ariel
      */
     void Player::deductResources(const string &type)
     {
-        // Deduct settlement resources
-        if (type == "settlement")
+        Purchase purchase;
+        DevCard card;
+        // Deduct the cost of a purchase
+        if (parsePurchase(type, purchase))
         {
-            resources["wool"]--;
-            resources["brick"]--;
-            resources["grain"]--;
-            resources["lumber"]--;
-            sumeOfResources -= 4;
-            cout << "Settlement purchased." << endl;
+            deductResources(purchase);
         }
-        // Deduct city resources
-        else if (type == "city")
+        // Deduct a played development card
+        else if (parseDevCard(type, card))
         {
-            resources["ore"] -= 3;
-            resources["grain"] -= 2;
-            sumeOfResources -= 5;
-            cout << "City purchased." << endl;
-        }
-        // Deduct road resources
-        else if (type == "road")
-        {
-            resources["lumber"]--;
-            resources["brick"]--;
-            sumeOfResources -= 2;
-            cout << "Road purchased." << endl;
-        }
-        // Deduct development card resources
-        else if (type == "development card")
-        {
-            resources["ore"]--;
-            resources["grain"]--;
-            resources["wool"]--;
-            sumeOfResources -= 3;
-            cout << "Development card purchased." << endl;
-        }
-        // Deduct knight card
-        else if (type == "knight")
-        {
-            devCards["knight"]--;
-            cout << "Knight card played." << endl;
-        }
-        // Deduct year of plenty card
-        else if (type == "year of plenty")
-        {
-            devCards["year of plenty"]--;
-            cout << "Year of plenty card played." << endl;
-        }
-        // Deduct monopoly card
-        else if (type == "monopoly")
-        {
-            devCards["monopoly"]--;
-            cout << "Monopoly card played." << endl;
-        }
-        // Deduct road building card
-        else if (type == "road building")
-        {
-            devCards["road building"]--;
-            cout << "Road building card played." << endl;
-        }
-        // Handle unknown type
-        else
-        {
-            cout << "Unknown type." << endl;
+            removeDevelopmentCard(card);
         }
     }
 
     /**
      * Deducts a specified amount of a resource from the player's resources.
      *
-     * @param type The type of resource to deduct.
+     * @param resource The resource to deduct.
      * @param amount The amount of the resource to deduct.
      */
-    void Player::deductResources(const string &type, int amount)
+    void Player::deductResources(Resource resource, int amount)
     {
         // Check if the amount is valid.
         if (amount > 0)
         {
             // Deduct the specified amount of the resource.
-            if (type == "wool")
-            {
-                resources["wool"] -= amount;
-                sumeOfResources -= amount;
-            }
-            else if (type == "brick")
-            {
-                resources["brick"] -= amount;
-                sumeOfResources -= amount;
-            }
-            else if (type == "grain")
-            {
-                resources["grain"] -= amount;
-                sumeOfResources -= amount;
-            }
-            else if (type == "lumber")
-            {
-                resources["lumber"] -= amount;
-                sumeOfResources -= amount;
-            }
-            else if (type == "ore")
-            {
-                resources["ore"] -= amount;
-                sumeOfResources -= amount;
-            }
+            changeResource((size_t)resource, -amount);
+        }
+    }
+
+    /**
+     * Deducts a specified amount of a resource from the player's resources.
+     *
+     * @param type The name of the resource to deduct.
+     * @param amount The amount of the resource to deduct.
+     */
+    void Player::deductResources(const string &type, int amount)
+    {
+        Resource resource;
+        if (parseResource(type, resource))
+        {
+            deductResources(resource, amount);
         }
     }
 
@@ -336,43 +418,42 @@ namespace ariel
      * It deducts half of the resources from the player.
      * It selects resources randomly and discards one unit of the chosen resource.
      *
+     * @param rng The random number generator of the game.
+     *
      * @throws None
      */
-    void Player::itsSeven()
+    void Player::itsSeven(Rng &rng)
     {
         // Check if the player has more than 7 resources.
         if (sumeOfResources > 7)
         {
             // Calculate half the resources.
             int half = sumeOfResources / 2;
+            LOG_DEBUG(name << " discards " << half << " resources on a 7");
 
             // Iterate for half the resources.
             for (int i = 0; i < half; i++)
             {
-                // Vector to hold the resources that the player has.
-                vector<string> availableResources;
-
-                // Iterate over the resources that the player has.
-                for (const auto &entry : resources)
+                // Collect the resources that the player has.
+                Resource availableResources[NUM_RESOURCES];
+                size_t count = 0;
+                for (size_t r = 0; r < NUM_RESOURCES; r++)
                 {
                     // Check if the resource count is greater than 0.
-                    if (entry.second > 0)
+                    if (resources[r] > 0)
                     {
-                        // Add the resource type to the vector.
-                        availableResources.push_back(entry.first);
+                        availableResources[count++] = (Resource)r;
                     }
                 }
 
                 // Check if there are available resources.
-                if (!availableResources.empty())
+                if (count > 0)
                 {
                     // Pick a random resource from the available resources.
-                    size_t index = static_cast<size_t>(rand()) % availableResources.size();
-                    string resource = availableResources[index];
+                    size_t index = rng.below((uint32_t)count);
 
                     // Discard one unit of the chosen resource.
-                    resources[resource]--;
-                    sumeOfResources--;
+                    changeResource((size_t)availableResources[index], -1);
                 }
             }
         }
@@ -387,10 +468,10 @@ namespace ariel
     void Player::printResources()
     {
         // Iterate over the resources held by the player.
-        for (const auto &entry : resources)
+        for (size_t i = 0; i < NUM_RESOURCES; i++)
         {
             // Print the resource type and count.
-            cout << entry.first << ": " << entry.second << endl;
+            cout << RESOURCE_NAMES[i] << ": " << resources[i] << '\n';
         }
     }
 
@@ -411,6 +492,10 @@ namespace ariel
     {
         // Increment the number of settlements owned by the player
         numOfSettlements++;
+        if (journal && journal->isRecording())
+        {
+            journal->add({ChangeKind::SettlementCount, id, 0, 1, {}, {}});
+        }
     }
 
    
@@ -425,11 +510,39 @@ namespace ariel
     {
         numOfCities++;
         numOfSettlements--;
+        if (journal && journal->isRecording())
+        {
+            journal->add({ChangeKind::CityCount, id, 0, 1, {}, {}});
+        }
+    }
+
+    void Player::addDevelopmentCard(DevCard card)
+    {
+        changeDevelopmentCard((size_t)card, 1);
     }
 
     void Player::addDevelopmentCard(string card)
     {
-        devCards[card]++;
+        DevCard type;
+        if (parseDevCard(card, type))
+        {
+            addDevelopmentCard(type);
+        }
+    }
+
+    bool Player::hasDevelopmentCard(DevCard card) const
+    {
+        return devCards[(size_t)card] > 0;
+    }
+
+    void Player::removeDevelopmentCard(DevCard card)
+    {
+        changeDevelopmentCard((size_t)card, -1);
+    }
+
+    int Player::amountOfDevelopmentCards(DevCard card) const
+    {
+        return devCards[(size_t)card];
     }
 
     /**
@@ -442,7 +555,21 @@ namespace ariel
      */
     int Player::amountOfKnights()
     {
-        return devCards["knight"];
+        return devCards[(size_t)DevCard::Knight];
+    }
+
+    /**
+     * @brief Check if the player has a specified amount of a resource.
+     *
+     * @param resource The resource to check.
+     * @param amount The amount of the resource.
+     *
+     * @return True if the player has at least the specified amount of the
+     * resource, false otherwise.
+     */
+    bool Player::haveResources(Resource resource, int amount) const
+    {
+        return resources[(size_t)resource] >= amount;
     }
 
     /**
@@ -461,8 +588,8 @@ namespace ariel
      */
     bool Player::haveResources(string type, int amount)
     {
-        // Check if the player has at least the specified amount of the resource.
-        return resources[type] >= amount;
+        Resource resource;
+        return parseResource(type, resource) && haveResources(resource, amount);
     }
 
     /**
@@ -472,8 +599,13 @@ namespace ariel
      */
     void Player::addKnights(int amount)
     {
-        // Increase the number of Knight cards in the devCards map by the specified amount.
-        devCards["knight"] += amount;
+        // Increase the number of Knight cards by the specified amount.
+        changeDevelopmentCard((size_t)DevCard::Knight, amount);
+    }
+
+    int Player::amountOfResources(Resource resource) const
+    {
+        return resources[(size_t)resource];
     }
 
     /**
@@ -484,8 +616,13 @@ namespace ariel
      */
     int Player::amountOfResources(string type)
     {
-        // Retrieve the amount of the specified resource from the resources map.
-        return resources[type];
+        Resource resource;
+        return parseResource(type, resource) ? resources[(size_t)resource] : 0;
+    }
+
+    int Player::getTotalResources() const
+    {
+        return sumeOfResources;
     }
 
     /**
@@ -496,7 +633,7 @@ namespace ariel
     bool Player::haveAllKnights()
     {
         // Check if the player has at least 3 Knight cards.
-        return devCards["knight"] >= 3;
+        return devCards[(size_t)DevCard::Knight] >= 3;
     }
 
     /**
@@ -506,22 +643,46 @@ namespace ariel
      */
     int Player::amountOfVictoryPoint()
     {
-        return devCards["victory point"];
+        return devCards[(size_t)DevCard::VictoryPoint];
     }
 
     int Player::getAmountOfDevCards()
     {
         int sum = 0;
-        for (auto &card : devCards)
+        for (int count : devCards)
         {
-            sum += card.second;
+            sum += count;
         }
         return sum;
     }
 
     map<string, int> Player::getDevelopmentCards()
     {
-        return devCards;
+        map<string, int> cards;
+        for (size_t i = 0; i < NUM_DEV_CARDS; i++)
+        {
+            cards[DEV_CARD_NAMES[i]] = devCards[i];
+        }
+        return cards;
+    }
+
+    bool Player::hasLongestRoad() const
+    {
+        return longestRoad;
+    }
+
+    void Player::setLongestRoad(bool holds)
+    {
+        longestRoad = holds;
+    }
+
+    uint64_t Player::getHash() const
+    {
+        return hash;
+    }
+
+    void Player::setJournal(Journal *journal)
+    {
+        this->journal = journal;
     }
-    
-}
\ No newline at end of file
+}
@@ -5,46 +5,137 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <array>
+#include <cstdint>
+
+#include "rng.hpp"
+#include "zobrist.hpp"
 
 using namespace std;
 
 namespace ariel
 {
 
+    // Owner value of a vertex or edge that no player has built on
+    const uint8_t NO_PLAYER = 0xFF;
+
+    // Resource types, in the order they are printed
+    enum class Resource : uint8_t
+    {
+        Brick,
+        Grain,
+        Lumber,
+        Ore,
+        Wool
+    };
+    const size_t NUM_RESOURCES = 5;
+
+    // Whether a value names one of the resources; actions can carry any byte
+    inline bool isResource(Resource resource)
+    {
+        return (size_t)resource < NUM_RESOURCES;
+    }
+
+    // Development card types, in the order they are listed
+    enum class DevCard : uint8_t
+    {
+        Knight,
+        Monopoly,
+        RoadBuilding,
+        VictoryPoint,
+        YearOfPlenty
+    };
+    const size_t NUM_DEV_CARDS = 5;
+
+    // Things a player can pay for with resources
+    enum class Purchase : uint8_t
+    {
+        Settlement,
+        City,
+        Road,
+        DevelopmentCard
+    };
+    const size_t NUM_PURCHASES = 4;
+
+    // Conversions between the enums and the names used in the user interface
+    const string &resourceName(Resource resource);
+    const string &devCardName(DevCard card);
+    bool parseResource(const string &name, Resource &resource);
+    bool parseDevCard(const string &name, DevCard &card);
+    bool parsePurchase(const string &name, Purchase &purchase);
+
+    // Resources needed for a purchase, indexed by Resource
+    const int *purchaseCost(Purchase purchase);
+
+    class Journal;
+
     class Player
     {
+        friend class GameState;
+        friend class Journal;
+
     private:
         string name;
-        map<string, int> resources;
-        map<string, int> devCards;
+        uint8_t id;
+        array<int, NUM_RESOURCES> resources; // Indexed by Resource
+        array<int, NUM_DEV_CARDS> devCards;  // Indexed by DevCard
         int sumeOfResources;
         int numOfSettlements;
         int numOfCities;
         int points;
+        bool longestRoad; // Holds the Longest Road card
+        uint64_t hash;    // Zobrist hash of the hand and the development cards
+        Journal *journal; // Receives every change while a move is recorded, if set
+
+        void changeResource(size_t resource, int amount);
+        void changeDevelopmentCard(size_t card, int amount);
+        void rehash();
 
     public:
-        Player(const string &name);
+        Player(const string &name, uint8_t id = 0);
+        static bool isResource(const string &type);
         const string &getName() const;
+        uint8_t getId() const;
+        void setId(uint8_t id);
+        void addResource(Resource resource, int amount);
         void addResource(const string &resource, int amount);
-        void trade(Player &other, const string &giveResource, const string &receiveResource, int giveAmount, int receiveAmount);
+        bool trade(Player &other, Resource giveResource, Resource receiveResource, int giveAmount, int receiveAmount);
         int getPoints();
+        bool hasEnoughResources(Purchase purchase) const;
         bool hasEnoughResources(const string &type);
+        void deductResources(Purchase purchase);
         void deductResources(const string &type);
+        void deductResources(Resource resource, int amount);
         void deductResources(const string &type, int amount);
-        void itsSeven();
+        void itsSeven(Rng &rng);
         void printResources();
         int getNumOfSettlementsAndCities();
         void increaseNumOfSettlements();
         void increaseNumOfCities();
+        void addDevelopmentCard(DevCard card);
         void addDevelopmentCard(string card);
+        bool hasDevelopmentCard(DevCard card) const;
+        void removeDevelopmentCard(DevCard card);
+        int amountOfDevelopmentCards(DevCard card) const;
         int amountOfKnights();
+        bool haveResources(Resource resource, int amount) const;
         bool haveResources(string type, int amount);
         void addKnights(int amount);
+        int amountOfResources(Resource resource) const;
         int amountOfResources(string type);
+        int getTotalResources() const;
         bool haveAllKnights();
         int amountOfVictoryPoint();
         map <string, int> getDevelopmentCards();
         int getAmountOfDevCards();
+        bool hasLongestRoad() const;
+        void setLongestRoad(bool holds);
+
+        // Zobrist hash of the player's resources and development cards
+        uint64_t getHash() const;
+
+        // Reports every change of the hand, cards and counts to the journal; null stops it
+        void setJournal(Journal *journal);
     };
 }
 
@@ -0,0 +1,148 @@
+#include "rating.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace ariel
+{
+
+    /**
+     * Starts every entry at the same rating.
+     *
+     * @param numOfEntries The number of entries.
+     * @param initial The rating of an entry that has not played.
+     * @param k The most a rating can move in one game.
+     */
+    EloRatings::EloRatings(size_t numOfEntries, double initial, double k)
+        : k(k), ratings(numOfEntries, initial), games(numOfEntries, 0), wins(numOfEntries, 0), points(numOfEntries, 0)
+    {
+    }
+
+    double EloRatings::expected(double a, double b)
+    {
+        return 1.0 / (1.0 + pow(10.0, (b - a) / 400.0));
+    }
+
+    /**
+     * Scores every entry against every other entry of the game and moves its rating by
+     * k times its total score above expectation, divided by the number of opponents so
+     * that a game is worth the same whatever the number of seats. All the changes are
+     * computed from the ratings before the game, so the ratings keep their sum.
+     *
+     * @param seats The entry that played each seat.
+     * @param result The result of the game, with the points of each seat.
+     */
+    void EloRatings::update(const vector<size_t> &seats, const GameResult &result)
+    {
+        if (seats.size() < 2 || seats.size() != result.points.size())
+        {
+            throw invalid_argument("A rated game needs the points of every seat");
+        }
+        vector<double> change(seats.size(), 0.0);
+        for (size_t i = 0; i < seats.size(); i++)
+        {
+            for (size_t j = 0; j < seats.size(); j++)
+            {
+                if (i == j)
+                {
+                    continue;
+                }
+                double score;
+                if (result.winner == (int)i || result.winner == (int)j)
+                {
+                    score = result.winner == (int)i ? 1.0 : 0.0;
+                }
+                else
+                {
+                    score = result.points[i] > result.points[j] ? 1.0 : result.points[i] < result.points[j] ? 0.0 : 0.5;
+                }
+                change[i] += score - expected(ratings[seats[i]], ratings[seats[j]]);
+            }
+        }
+
+        double scale = k / (double)(seats.size() - 1);
+        for (size_t i = 0; i < seats.size(); i++)
+        {
+            size_t entry = seats[i];
+            ratings[entry] += scale * change[i];
+            games[entry]++;
+            wins[entry] += result.winner == (int)i ? 1 : 0;
+            points[entry] += result.points[i];
+        }
+    }
+
+    vector<size_t> EloRatings::standings() const
+    {
+        vector<size_t> order(ratings.size());
+        for (size_t i = 0; i < order.size(); i++)
+        {
+            order[i] = i;
+        }
+        stable_sort(order.begin(), order.end(), [this](size_t a, size_t b) { return ratings[a] > ratings[b]; });
+        return order;
+    }
+
+    // Appends every combination of seats entries out of numOfEntries, starting from the partial one
+    static void combinations(size_t numOfEntries, size_t seats, vector<size_t> &partial, vector<vector<size_t>> &out)
+    {
+        if (partial.size() == seats)
+        {
+            out.push_back(partial);
+            return;
+        }
+        for (size_t entry = partial.empty() ? 0 : partial.back() + 1; entry < numOfEntries; entry++)
+        {
+            partial.push_back(entry);
+            combinations(numOfEntries, seats, partial, out);
+            partial.pop_back();
+        }
+    }
+
+    vector<vector<size_t>> roundRobinPairings(size_t numOfEntries, size_t seats)
+    {
+        if (seats < 2 || numOfEntries < seats)
+        {
+            throw invalid_argument("A round robin needs at least as many entries as seats");
+        }
+        vector<vector<size_t>> groups;
+        vector<size_t> partial;
+        combinations(numOfEntries, seats, partial, groups);
+
+        vector<vector<size_t>> pairings;
+        for (vector<size_t> &group : groups)
+        {
+            for (size_t rotation = 0; rotation < seats; rotation++)
+            {
+                pairings.push_back(group);
+                rotate(group.begin(), group.begin() + 1, group.end());
+            }
+        }
+        return pairings;
+    }
+
+    vector<vector<size_t>> swissPairings(const EloRatings &ratings, size_t seats, Rng &rng)
+    {
+        if (seats < 2 || ratings.size() < seats)
+        {
+            throw invalid_argument("A Swiss round needs at least as many entries as seats");
+        }
+        vector<size_t> order(ratings.size());
+        for (size_t i = 0; i < order.size(); i++)
+        {
+            order[i] = i;
+        }
+        rng.shuffle(order);
+        stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return ratings.getRating(a) > ratings.getRating(b); });
+
+        vector<vector<size_t>> pairings;
+        for (size_t start = 0; start < order.size(); start += seats)
+        {
+            size_t first = min(start, order.size() - seats);
+            vector<size_t> group(order.begin() + (ptrdiff_t)first, order.begin() + (ptrdiff_t)(first + seats));
+            rng.shuffle(group);
+            pairings.push_back(group);
+        }
+        return pairings;
+    }
+}
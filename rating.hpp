@@ -0,0 +1,56 @@
+#ifndef RATING_HPP
+#define RATING_HPP
+
+#include <cstddef>
+#include <vector>
+
+#include "rng.hpp"
+#include "simulation.hpp"
+
+using namespace std;
+
+namespace ariel
+{
+
+    // Elo ratings of the entries of a tournament, updated one game at a time. A game
+    // between several entries counts as a match between every two of them: the winner
+    // beats everyone, and the others are ranked by points, with equal points a draw.
+    class EloRatings
+    {
+    private:
+        double k; // Most a rating moves in one game
+        vector<double> ratings;
+        vector<long> games;
+        vector<long> wins;
+        vector<long> points;
+
+    public:
+        explicit EloRatings(size_t numOfEntries, double initial = 1500.0, double k = 32.0);
+
+        // Updates the ratings with a finished game; seats[i] is the entry that played seat i
+        void update(const vector<size_t> &seats, const GameResult &result);
+
+        // Chance that an entry rated a beats one rated b
+        static double expected(double a, double b);
+
+        size_t size() const { return ratings.size(); }
+        double getRating(size_t entry) const { return ratings[entry]; }
+        long getGames(size_t entry) const { return games[entry]; }
+        long getWins(size_t entry) const { return wins[entry]; }
+        long getPoints(size_t entry) const { return points[entry]; }
+
+        // Entries from the highest rating to the lowest
+        vector<size_t> standings() const;
+    };
+
+    // Every group of distinct entries, each in every rotation of the seats, so that all
+    // entries play each other equally often and sit in every seat equally often
+    vector<vector<size_t>> roundRobinPairings(size_t numOfEntries, size_t seats);
+
+    // One Swiss round: entries sorted by rating, ties in random order, play in groups of
+    // neighbors in a random seat order. If the entries do not divide into groups, the last
+    // group takes the lowest rated entries, so a few of them play twice in the round.
+    vector<vector<size_t>> swissPairings(const EloRatings &ratings, size_t seats, Rng &rng);
+}
+
+#endif
@@ -0,0 +1,424 @@
+#include "record.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace ariel
+{
+
+    static const char MAGIC[4] = {'C', 'T', 'N', 'R'};
+
+    // Reads a little-endian varint, throwing if it runs past the end
+    static uint32_t readVarint(const uint8_t *&p, const uint8_t *end)
+    {
+        uint32_t value = 0;
+        for (int shift = 0; shift < 35; shift += 7)
+        {
+            if (p == end)
+            {
+                throw runtime_error("Game record is truncated");
+            }
+            uint8_t byte = *p++;
+            value |= (uint32_t)(byte & 0x7F) << shift;
+            if (!(byte & 0x80))
+            {
+                return value;
+            }
+        }
+        throw runtime_error("Game record has a malformed number");
+    }
+
+    static uint8_t readByte(const uint8_t *&p, const uint8_t *end)
+    {
+        if (p == end)
+        {
+            throw runtime_error("Game record is truncated");
+        }
+        return *p++;
+    }
+
+    // Largest amount of cards a recorded move may move; hands are counted in 16 bits
+    static const uint32_t MAX_AMOUNT = 0x7FFF;
+
+    // Longest run of moves a record may hold, far beyond any game the turn limits allow
+    static const uint32_t MAX_MOVE_BYTES = 1 << 24;
+
+    static Resource toResource(uint8_t value)
+    {
+        if (value >= NUM_RESOURCES)
+        {
+            throw runtime_error("Game record has an unknown resource");
+        }
+        return (Resource)value;
+    }
+
+    // Reads a seat of the game other than a placeholder
+    static int readSeat(const uint8_t *&p, const uint8_t *end, size_t numOfPlayers)
+    {
+        uint32_t seat = readVarint(p, end);
+        if (seat >= numOfPlayers)
+        {
+            throw runtime_error("Game record names seat " + to_string(seat) + " of " + to_string(numOfPlayers));
+        }
+        return (int)seat;
+    }
+
+    static int readAmount(const uint8_t *&p, const uint8_t *end)
+    {
+        uint32_t amount = readVarint(p, end);
+        if (amount > MAX_AMOUNT)
+        {
+            throw runtime_error("Game record has an amount of " + to_string(amount));
+        }
+        return (int)amount;
+    }
+
+    static int readLocation(const uint8_t *&p, const uint8_t *end, int limit)
+    {
+        uint32_t location = readVarint(p, end);
+        if (location >= (uint32_t)limit)
+        {
+            throw runtime_error("Game record has a location off the board");
+        }
+        return (int)location;
+    }
+
+    // Byte describing a tile: resource in the high nibble (NUM_RESOURCES for the desert), number in the low one
+    static uint8_t tileByte(const Tile &tile)
+    {
+        size_t resource = tile.desert ? NUM_RESOURCES : (size_t)tile.resource;
+        return (uint8_t)((resource << 4) | ((size_t)tile.number & 0x0F));
+    }
+
+    GameRecord::GameRecord() : seed(0), numOfPlayers(0), numOfMoves(0), finalHash(0)
+    {
+        tiles.fill(0);
+    }
+
+    /**
+     * Starts an empty record of a game that has not been played yet.
+     *
+     * @param game The game to record; its board must be freshly initialized.
+     */
+    GameRecord::GameRecord(Catan &game) : seed(game.getSeed()), numOfPlayers((uint8_t)game.getNumOfPlayers()), numOfMoves(0), finalHash(0)
+    {
+        for (int i = 0; i < NUM_TILES; i++)
+        {
+            tiles[(size_t)i] = tileByte(game.getBoard().getTile(i));
+        }
+    }
+
+    void GameRecord::writeVarint(uint32_t value)
+    {
+        while (value >= 0x80)
+        {
+            moves.push_back((uint8_t)(value | 0x80));
+            value >>= 7;
+        }
+        moves.push_back((uint8_t)value);
+    }
+
+    /**
+     * Appends an action that the game accepted. Only the fields the action type
+     * uses are stored, so most actions take one or two bytes.
+     *
+     * @param action The applied action.
+     */
+    void GameRecord::recordAction(const Action &action)
+    {
+        moves.push_back((uint8_t)action.type);
+        numOfMoves++;
+        switch (action.type)
+        {
+        case ActionType::PlaceSettlement:
+        case ActionType::PlaceRoad:
+        case ActionType::UpgradeSettlement:
+            writeVarint((uint32_t)action.location);
+            break;
+        case ActionType::PlayYearOfPlenty:
+            moves.push_back((uint8_t)(((uint8_t)action.resource << 4) | (uint8_t)action.secondResource));
+            break;
+        case ActionType::PlayMonopoly:
+            moves.push_back((uint8_t)action.resource);
+            break;
+        case ActionType::PlayRoadBuilding:
+            writeVarint((uint32_t)action.location);
+            writeVarint((uint32_t)action.secondLocation);
+            break;
+        case ActionType::TradeResources:
+            writeVarint((uint32_t)action.otherPlayer);
+            moves.push_back((uint8_t)(((uint8_t)action.resource << 4) | (uint8_t)action.secondResource));
+            writeVarint((uint32_t)action.amount);
+            writeVarint((uint32_t)action.secondAmount);
+            break;
+        case ActionType::SellKnight:
+        case ActionType::BuyKnight:
+            writeVarint((uint32_t)action.otherPlayer);
+            moves.push_back((uint8_t)action.resource);
+            writeVarint((uint32_t)action.knights);
+            writeVarint((uint32_t)action.amount);
+            break;
+        default:
+            break;
+        }
+    }
+
+    /**
+     * Appends a change of seat made outside Catan::apply.
+     *
+     * @param op NextPlayer, PreviousPlayer or ChooseStartingPlayer.
+     */
+    void GameRecord::recordSeatChange(RecordOp op)
+    {
+        moves.push_back((uint8_t)op);
+        numOfMoves++;
+    }
+
+    void GameRecord::truncate(size_t numOfMoves, size_t bytes)
+    {
+        if (numOfMoves <= this->numOfMoves && bytes <= moves.size())
+        {
+            this->numOfMoves = (uint32_t)numOfMoves;
+            moves.resize(bytes);
+        }
+    }
+
+    void GameRecord::finish(const Catan &game)
+    {
+        finalHash = game.getHash();
+    }
+
+    /**
+     * Re-executes the recorded moves through the engine.
+     *
+     * @param game A new game with the record's seed and number of players.
+     * @return The number of moves applied.
+     * @throws runtime_error if the game does not follow the record.
+     */
+    size_t GameRecord::replay(Catan &game) const
+    {
+        if (game.getSeed() != seed || game.getNumOfPlayers() != numOfPlayers)
+        {
+            throw runtime_error("Game record is for a different game");
+        }
+        for (int i = 0; i < NUM_TILES; i++)
+        {
+            if (tileByte(game.getBoard().getTile(i)) != tiles[(size_t)i])
+            {
+                throw runtime_error("Game record has a different tile layout");
+            }
+        }
+
+        const uint8_t *p = moves.data();
+        const uint8_t *end = p + moves.size();
+        size_t applied = 0;
+        while (p != end)
+        {
+            RecordOp op = (RecordOp)*p++;
+            Action action((ActionType)op);
+            switch (op)
+            {
+            case RecordOp::NextPlayer:
+                game.nextPlayer();
+                applied++;
+                continue;
+            case RecordOp::PreviousPlayer:
+                game.previousPlayer();
+                applied++;
+                continue;
+            case RecordOp::ChooseStartingPlayer:
+                game.ChooseStartingPlayer();
+                applied++;
+                continue;
+            case RecordOp::PlaceSettlement:
+            case RecordOp::UpgradeSettlement:
+                action.location = readLocation(p, end, NUM_VERTICES);
+                break;
+            case RecordOp::PlaceRoad:
+                action.location = readLocation(p, end, NUM_EDGES);
+                break;
+            case RecordOp::PlayYearOfPlenty:
+            {
+                uint8_t pair = readByte(p, end);
+                action.resource = toResource((uint8_t)(pair >> 4));
+                action.secondResource = toResource((uint8_t)(pair & 0x0F));
+                break;
+            }
+            case RecordOp::PlayMonopoly:
+                action.resource = toResource(readByte(p, end));
+                break;
+            case RecordOp::PlayRoadBuilding:
+                action.location = readLocation(p, end, NUM_EDGES);
+                action.secondLocation = readLocation(p, end, NUM_EDGES);
+                break;
+            case RecordOp::TradeResources:
+            {
+                action.otherPlayer = readSeat(p, end, game.getNumOfPlayers());
+                uint8_t pair = readByte(p, end);
+                action.resource = toResource((uint8_t)(pair >> 4));
+                action.secondResource = toResource((uint8_t)(pair & 0x0F));
+                action.amount = readAmount(p, end);
+                action.secondAmount = readAmount(p, end);
+                break;
+            }
+            case RecordOp::SellKnight:
+            case RecordOp::BuyKnight:
+                action.otherPlayer = readSeat(p, end, game.getNumOfPlayers());
+                action.resource = toResource(readByte(p, end));
+                action.knights = readAmount(p, end);
+                action.amount = readAmount(p, end);
+                break;
+            case RecordOp::RollDice:
+            case RecordOp::BuyDevelopmentCard:
+            case RecordOp::EndTurn:
+                break;
+            default:
+                throw runtime_error("Game record has an unknown move");
+            }
+            if (game.apply(action) != ActionResult::Success)
+            {
+                throw runtime_error("Game record move " + to_string(applied) + " was rejected");
+            }
+            applied++;
+        }
+
+        if (game.getHash() != finalHash)
+        {
+            throw runtime_error("Game record ends in a different position");
+        }
+        return applied;
+    }
+
+    // Writes an unsigned integer in little-endian order
+    static void writeFixed(ostream &out, uint64_t value, int bytes)
+    {
+        for (int i = 0; i < bytes; i++)
+        {
+            out.put((char)(uint8_t)(value >> (8 * i)));
+        }
+    }
+
+    static void writeStreamVarint(ostream &out, uint64_t value)
+    {
+        while (value >= 0x80)
+        {
+            out.put((char)(uint8_t)(value | 0x80));
+            value >>= 7;
+        }
+        out.put((char)(uint8_t)value);
+    }
+
+    void GameRecord::write(ostream &out) const
+    {
+        out.write(MAGIC, sizeof(MAGIC));
+        out.put((char)VERSION);
+        writeFixed(out, seed, 8);
+        out.put((char)numOfPlayers);
+        out.write((const char *)tiles.data(), (streamsize)tiles.size());
+        writeStreamVarint(out, numOfMoves);
+        writeStreamVarint(out, moves.size());
+        out.write((const char *)moves.data(), (streamsize)moves.size());
+        writeFixed(out, finalHash, 8);
+    }
+
+    // Reads exactly the given number of bytes, throwing on a short read
+    static void readExactly(istream &in, void *buffer, size_t size)
+    {
+        in.read((char *)buffer, (streamsize)size);
+        if ((size_t)in.gcount() != size)
+        {
+            throw runtime_error("Game record is truncated");
+        }
+    }
+
+    static uint64_t readFixed(istream &in, int bytes)
+    {
+        uint8_t buffer[8];
+        readExactly(in, buffer, (size_t)bytes);
+        uint64_t value = 0;
+        for (int i = bytes - 1; i >= 0; i--)
+        {
+            value = (value << 8) | buffer[i];
+        }
+        return value;
+    }
+
+    static uint32_t readStreamVarint(istream &in)
+    {
+        uint32_t value = 0;
+        for (int shift = 0; shift < 35; shift += 7)
+        {
+            uint8_t byte;
+            readExactly(in, &byte, 1);
+            value |= (uint32_t)(byte & 0x7F) << shift;
+            if (!(byte & 0x80))
+            {
+                return value;
+            }
+        }
+        throw runtime_error("Game record has a malformed number");
+    }
+
+    bool GameRecord::read(istream &in)
+    {
+        char magic[sizeof(MAGIC)];
+        in.read(magic, sizeof(magic));
+        if (in.gcount() == 0)
+        {
+            return false;
+        }
+        if ((size_t)in.gcount() != sizeof(magic) || memcmp(magic, MAGIC, sizeof(MAGIC)) != 0)
+        {
+            throw runtime_error("Not a game record");
+        }
+        uint8_t version;
+        readExactly(in, &version, 1);
+        if (version != VERSION)
+        {
+            throw runtime_error("Unsupported game record version " + to_string(version));
+        }
+
+        seed = readFixed(in, 8);
+        readExactly(in, &numOfPlayers, 1);
+        readExactly(in, tiles.data(), tiles.size());
+        numOfMoves = readStreamVarint(in);
+        uint32_t length = readStreamVarint(in);
+        if (length > MAX_MOVE_BYTES || numOfMoves > length)
+        {
+            throw runtime_error("Game record has a malformed length");
+        }
+        // Grow with the bytes actually read, so a wrong length runs into the end of the
+        // stream long before it can take much memory
+        moves.clear();
+        while (moves.size() < length)
+        {
+            size_t start = moves.size();
+            size_t chunk = min((size_t)length - start, (size_t)1 << 16);
+            moves.resize(start + chunk);
+            readExactly(in, moves.data() + start, chunk);
+        }
+        finalHash = readFixed(in, 8);
+        return true;
+    }
+
+    uint64_t GameRecord::getSeed() const
+    {
+        return seed;
+    }
+
+    uint8_t GameRecord::getNumOfPlayers() const
+    {
+        return numOfPlayers;
+    }
+
+    size_t GameRecord::getNumOfMoves() const
+    {
+        return numOfMoves;
+    }
+
+    size_t GameRecord::getSizeInBytes() const
+    {
+        return moves.size();
+    }
+}
@@ -0,0 +1,97 @@
+#ifndef RECORD_HPP
+#define RECORD_HPP
+
+#include <array>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+#include "catan.hpp"
+#include "action.hpp"
+
+using namespace std;
+
+namespace ariel
+{
+
+    // Opcodes of a recorded move: the action types first, then the seat changes
+    // that happen outside Catan::apply
+    enum class RecordOp : uint8_t
+    {
+        RollDice,
+        PlaceSettlement,
+        PlaceRoad,
+        UpgradeSettlement,
+        BuyDevelopmentCard,
+        PlayYearOfPlenty,
+        PlayMonopoly,
+        PlayRoadBuilding,
+        TradeResources,
+        SellKnight,
+        BuyKnight,
+        EndTurn,
+        NextPlayer,
+        PreviousPlayer,
+        ChooseStartingPlayer
+    };
+
+    // A compact binary log of one game: the seed, the tile layout and every move that
+    // changed the game, a few bytes each. Since the game is deterministic given its
+    // seed, replaying the moves on a new game with the same seed gives the same game.
+    //
+    // A record starts recording when it is attached to a game with Catan::setRecord;
+    // the game then appends every successful action and every change of seat.
+    //
+    // On disk a record is: "CTNR", version, seed (8 bytes), number of players, one byte
+    // per tile (resource << 4 | number, resource 5 for the desert), number of moves and
+    // length of the moves in bytes (both varints), the moves, and the Zobrist hash of
+    // the final position (8 bytes). Records can be concatenated into an archive.
+    class GameRecord
+    {
+    private:
+        uint64_t seed;
+        uint8_t numOfPlayers;
+        array<uint8_t, NUM_TILES> tiles;
+        vector<uint8_t> moves;
+        uint32_t numOfMoves;
+        uint64_t finalHash;
+
+        void writeVarint(uint32_t value);
+
+    public:
+        static const uint8_t VERSION = 1;
+
+        GameRecord();
+
+        // Starts an empty record of a new game: its seed and its tile layout
+        explicit GameRecord(Catan &game);
+
+        // Appends a successful action, or a change of seat
+        void recordAction(const Action &action);
+        void recordSeatChange(RecordOp op);
+
+        // Drops every move after the first numOfMoves, which took the given number of bytes;
+        // a journal uses it to take undone moves out again
+        void truncate(size_t numOfMoves, size_t bytes);
+
+        // Stores the hash of the final position, checked when the record is replayed
+        void finish(const Catan &game);
+
+        // Plays the record on a game created with the same seed and number of players;
+        // returns the number of moves applied. Throws runtime_error when the layout, an
+        // action or the final hash does not match.
+        size_t replay(Catan &game) const;
+
+        // Writes the record; reads the next one, returning false at the end of the stream.
+        // A truncated or corrupt record throws runtime_error.
+        void write(ostream &out) const;
+        bool read(istream &in);
+
+        uint64_t getSeed() const;
+        uint8_t getNumOfPlayers() const;
+        size_t getNumOfMoves() const;
+        size_t getSizeInBytes() const; // Bytes taken by the moves
+    };
+}
+
+#endif
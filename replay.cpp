@@ -0,0 +1,183 @@
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <memory>
+
+#include "record.hpp"
+
+using namespace std;
+using namespace ariel;
+
+// Totals gathered by one worker thread, merged at the end
+struct ReplayStatistics
+{
+    long games = 0;
+    long moves = 0;
+    long finished = 0;
+    long failed = 0;
+    vector<long> wins;
+    string firstError;
+};
+
+void usage()
+{
+    cerr << "Usage: replay [--threads T] FILE..." << endl;
+    exit(1);
+}
+
+/**
+ * Replays archived games written by simulate --record through the engine and checks
+ * that each ends in its recorded position. Prints the number of games and moves, the
+ * win rate by seat re-derived from the replayed games, and the replay speed.
+ */
+int main(int argc, char *argv[])
+{
+    unsigned numOfThreads = thread::hardware_concurrency();
+    vector<string> paths;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--threads") == 0)
+        {
+            if (i + 1 >= argc)
+            {
+                usage();
+            }
+            numOfThreads = (unsigned)atoi(argv[++i]);
+        }
+        else
+        {
+            paths.push_back(argv[i]);
+        }
+    }
+    if (paths.empty())
+    {
+        usage();
+    }
+    if (numOfThreads == 0)
+    {
+        numOfThreads = 1;
+    }
+
+    // Load every record first, so the timing covers only the replay
+    vector<GameRecord> records;
+    size_t bytes = 0;
+    for (const string &path : paths)
+    {
+        ifstream in(path, ios::binary);
+        if (!in)
+        {
+            cerr << "Cannot read " << path << endl;
+            return 1;
+        }
+        try
+        {
+            GameRecord record;
+            while (record.read(in))
+            {
+                bytes += record.getSizeInBytes();
+                records.push_back(record);
+            }
+        }
+        catch (const runtime_error &error)
+        {
+            cerr << path << ": " << error.what() << endl;
+            return 1;
+        }
+    }
+
+    atomic<size_t> nextRecord(0);
+    vector<ReplayStatistics> statistics(numOfThreads);
+    vector<thread> workers;
+    auto start = chrono::steady_clock::now();
+    for (unsigned t = 0; t < numOfThreads; t++)
+    {
+        workers.push_back(thread([&, t]()
+                                 {
+            ReplayStatistics &stats = statistics[t];
+            for (size_t i = nextRecord++; i < records.size(); i = nextRecord++)
+            {
+                const GameRecord &record = records[i];
+                vector<Player> seats;
+                for (size_t seat = 0; seat < record.getNumOfPlayers(); seat++)
+                {
+                    seats.push_back(Player("Seat " + to_string(seat + 1)));
+                }
+                stats.games++;
+                unique_ptr<Catan> game;
+                try
+                {
+                    game.reset(new Catan(seats, record.getSeed()));
+                    stats.moves += (long)record.replay(*game);
+                }
+                catch (const exception &error)
+                {
+                    if (stats.failed++ == 0)
+                    {
+                        stats.firstError = "seed " + to_string(record.getSeed()) + ": " + error.what();
+                    }
+                    continue;
+                }
+                stats.wins.resize(max(stats.wins.size(), game->getNumOfPlayers()), 0);
+                for (size_t seat = 0; seat < game->getNumOfPlayers(); seat++)
+                {
+                    if (game->getPlayer(seat).getPoints() >= 10)
+                    {
+                        stats.finished++;
+                        stats.wins[seat]++;
+                        break;
+                    }
+                }
+            } }));
+    }
+    for (auto &worker : workers)
+    {
+        worker.join();
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    ReplayStatistics total;
+    for (const ReplayStatistics &stats : statistics)
+    {
+        total.games += stats.games;
+        total.moves += stats.moves;
+        total.finished += stats.finished;
+        total.failed += stats.failed;
+        total.wins.resize(max(total.wins.size(), stats.wins.size()), 0);
+        for (size_t i = 0; i < stats.wins.size(); i++)
+        {
+            total.wins[i] += stats.wins[i];
+        }
+        if (total.firstError.empty())
+        {
+            total.firstError = stats.firstError;
+        }
+    }
+
+    cout << fixed << setprecision(2);
+    cout << "Games:      " << total.games << " (" << numOfThreads << " threads)" << endl;
+    cout << "Moves:      " << total.moves << " (" << (total.moves ? (double)bytes / (double)total.moves : 0.0) << " bytes each)" << endl;
+    cout << "Finished:   " << total.finished << endl;
+    cout << "Failed:     " << total.failed << endl;
+    if (total.failed)
+    {
+        cout << "  " << total.firstError << endl;
+    }
+    cout << "Win rate by seat:" << endl;
+    for (size_t i = 0; i < total.wins.size(); i++)
+    {
+        double rate = total.games ? 100.0 * (double)total.wins[i] / (double)total.games : 0.0;
+        cout << "  Seat " << i + 1 << ": " << rate << "%" << endl;
+    }
+    cout << setprecision(0);
+    cout << "Moves/sec:  " << (seconds > 0 ? (double)total.moves / seconds : 0.0) << " ("
+         << (seconds > 0 ? (double)total.moves / seconds / numOfThreads : 0.0) << " per thread)" << endl;
+    return total.failed ? 1 : 0;
+}
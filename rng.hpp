@@ -0,0 +1,100 @@
+#ifndef RNG_HPP
+#define RNG_HPP
+
+#include <cstdint>
+#include <random>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+namespace ariel
+{
+
+    // Small, fast random number generator (xoshiro256**) with an explicit seed.
+    // Every game owns one, so games are reproducible from their seed and never
+    // share state with each other or with the global rand().
+    class Rng
+    {
+    private:
+        uint64_t state[4];
+
+        static uint64_t rotl(uint64_t x, int k)
+        {
+            return (x << k) | (x >> (64 - k));
+        }
+
+    public:
+        explicit Rng(uint64_t seed = 0) { reseed(seed); }
+
+        // Restarts the stream from the given seed
+        void reseed(uint64_t seed)
+        {
+            // Expand the seed with splitmix64 so that similar seeds give unrelated streams
+            for (auto &word : state)
+            {
+                uint64_t z = (seed += 0x9E3779B97F4A7C15ULL);
+                z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+                z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+                word = z ^ (z >> 31);
+            }
+        }
+
+        // Returns the next 64 random bits
+        uint64_t next()
+        {
+            uint64_t result = rotl(state[1] * 5, 7) * 9;
+            uint64_t t = state[1] << 17;
+            state[2] ^= state[0];
+            state[3] ^= state[1];
+            state[1] ^= state[2];
+            state[0] ^= state[3];
+            state[2] ^= t;
+            state[3] = rotl(state[3], 45);
+            return result;
+        }
+
+        // Returns a uniform number in [0, bound), without modulo bias
+        uint32_t below(uint32_t bound)
+        {
+            uint64_t product = (next() >> 32) * bound;
+            uint32_t low = (uint32_t)product;
+            if (low < bound)
+            {
+                uint32_t threshold = (0u - bound) % bound;
+                while (low < threshold)
+                {
+                    product = (next() >> 32) * bound;
+                    low = (uint32_t)product;
+                }
+            }
+            return (uint32_t)(product >> 32);
+        }
+
+        // Rolls a single six-sided die
+        int rollDie()
+        {
+            return (int)below(6) + 1;
+        }
+
+        // Shuffles the items in place (Fisher-Yates)
+        template <typename T>
+        void shuffle(vector<T> &items)
+        {
+            for (size_t i = items.size(); i > 1; i--)
+            {
+                size_t j = below((uint32_t)i);
+                swap(items[i - 1], items[j]);
+            }
+        }
+
+        // Returns a seed taken from the operating system, for games that do not need to be reproduced
+        static uint64_t randomSeed()
+        {
+            random_device rd;
+            return ((uint64_t)rd() << 32) ^ rd();
+        }
+    };
+}
+
+#endif
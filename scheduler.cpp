@@ -0,0 +1,254 @@
+#include "scheduler.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace ariel
+{
+
+    // A submitted game; the runner is created when the game is first played
+    struct GameScheduler::Task
+    {
+        GameJob job;
+        GameCallback onComplete;
+        vector<unique_ptr<Bot>> owned;
+        vector<Bot *> bots;
+        GameRecord record;
+        unique_ptr<GameRunner> runner;
+    };
+
+    /**
+     * Starts the worker threads.
+     *
+     * @param numOfThreads The number of threads, or 0 for one per core.
+     * @param slice The number of bot decisions a game plays before it yields its thread.
+     * @param maxActive The most games started and not finished at once, or 0 for 64 per thread.
+     */
+    GameScheduler::GameScheduler(unsigned numOfThreads, long slice, size_t maxActive)
+        : slice(slice > 0 ? slice : 1), maxActive(maxActive), queued(0), sleeping(0), active(0), unfinished(0), stopping(false)
+    {
+        if (numOfThreads == 0)
+        {
+            numOfThreads = max(1u, thread::hardware_concurrency());
+        }
+        if (this->maxActive == 0)
+        {
+            this->maxActive = 64 * (size_t)numOfThreads;
+        }
+        for (unsigned t = 0; t < numOfThreads; t++)
+        {
+            queues.push_back(unique_ptr<WorkQueue>(new WorkQueue()));
+        }
+        for (unsigned t = 0; t < numOfThreads; t++)
+        {
+            workers.push_back(thread(&GameScheduler::work, this, (size_t)t));
+        }
+    }
+
+    GameScheduler::~GameScheduler()
+    {
+        wait();
+        {
+            lock_guard<mutex> guard(lock);
+            stopping = true;
+        }
+        workReady.notify_all();
+        for (auto &worker : workers)
+        {
+            worker.join();
+        }
+    }
+
+    /**
+     * Queues a game behind the ones already submitted. Its bots are created here, so
+     * an unknown strategy is reported to the caller instead of on a worker thread.
+     *
+     * @param job The seed, bots and turn limit of the game.
+     * @param onComplete Called with the result once the game is over. It runs on a
+     * worker thread, possibly at the same time as the callbacks of other games, and
+     * must not throw.
+     * @throws invalid_argument if a bot is unknown or the number of seats is not supported.
+     */
+    void GameScheduler::submit(const GameJob &job, GameCallback onComplete)
+    {
+        if (job.bots.size() < MIN_PLAYERS || job.bots.size() > MAX_PLAYERS)
+        {
+            throw invalid_argument("A game needs between " + to_string(MIN_PLAYERS) + " and " + to_string(MAX_PLAYERS) + " bots");
+        }
+        unique_ptr<Task> task(new Task());
+        task->job = job;
+        task->onComplete = onComplete;
+        for (const string &name : job.bots)
+        {
+            task->owned.push_back(createBot(name));
+            if (!task->owned.back())
+            {
+                throw invalid_argument("Unknown bot: " + name);
+            }
+            task->bots.push_back(task->owned.back().get());
+        }
+
+        {
+            lock_guard<mutex> guard(lock);
+            waiting.push_back(move(task));
+            unfinished++;
+        }
+        workReady.notify_one();
+    }
+
+    void GameScheduler::wait()
+    {
+        unique_lock<mutex> guard(lock);
+        allDone.wait(guard, [this]() { return unfinished == 0; });
+    }
+
+    size_t GameScheduler::pending() const
+    {
+        lock_guard<mutex> guard(lock);
+        return unfinished;
+    }
+
+    unique_ptr<GameScheduler::Task> GameScheduler::takeOwn(size_t self)
+    {
+        WorkQueue &queue = *queues[self];
+        lock_guard<mutex> guard(queue.lock);
+        if (queue.tasks.empty())
+        {
+            return unique_ptr<Task>();
+        }
+        unique_ptr<Task> task = move(queue.tasks.front());
+        queue.tasks.pop_front();
+        queued--;
+        return task;
+    }
+
+    unique_ptr<GameScheduler::Task> GameScheduler::startNext()
+    {
+        lock_guard<mutex> guard(lock);
+        if (waiting.empty() || active >= maxActive)
+        {
+            return unique_ptr<Task>();
+        }
+        unique_ptr<Task> task = move(waiting.front());
+        waiting.pop_front();
+        active++;
+        return task;
+    }
+
+    // Takes the newest game of the first other thread that has one, starting after this one
+    unique_ptr<GameScheduler::Task> GameScheduler::steal(size_t self)
+    {
+        for (size_t i = 1; i < queues.size() && queued > 0; i++)
+        {
+            WorkQueue &queue = *queues[(self + i) % queues.size()];
+            lock_guard<mutex> guard(queue.lock);
+            if (!queue.tasks.empty())
+            {
+                unique_ptr<Task> task = move(queue.tasks.back());
+                queue.tasks.pop_back();
+                queued--;
+                return task;
+            }
+        }
+        return unique_ptr<Task>();
+    }
+
+    /**
+     * Waits until there may be work. A thread announces that it sleeps before it looks
+     * for work one last time, and a thread that queues a game looks for sleepers after
+     * it has counted the game, so at least one of them sees the other.
+     *
+     * @return False once the scheduler is stopping.
+     */
+    bool GameScheduler::sleep()
+    {
+        unique_lock<mutex> guard(lock);
+        sleeping++;
+        workReady.wait(guard, [this]() {
+            return stopping || queued > 0 || (!waiting.empty() && active < maxActive);
+        });
+        sleeping--;
+        return !stopping;
+    }
+
+    void GameScheduler::wakeOne()
+    {
+        if (sleeping > 0)
+        {
+            {
+                lock_guard<mutex> guard(lock);
+            }
+            workReady.notify_one();
+        }
+    }
+
+    /**
+     * The loop of a worker thread: plays one slice of its oldest game, or of a new game,
+     * or of a game stolen from another thread, in that order, and puts it back at the end
+     * of its own queue unless it is over. The slice runs without any lock held.
+     *
+     * @param self The index of the thread and of its queue.
+     */
+    void GameScheduler::work(size_t self)
+    {
+        WorkQueue &own = *queues[self];
+        while (true)
+        {
+            unique_ptr<Task> task = takeOwn(self);
+            if (!task)
+            {
+                task = startNext();
+            }
+            if (!task)
+            {
+                task = steal(self);
+            }
+            if (!task)
+            {
+                if (!sleep())
+                {
+                    return;
+                }
+                continue;
+            }
+
+            if (!task->runner)
+            {
+                task->runner.reset(new GameRunner(task->bots, task->job.seed, task->job.maxTurns,
+                                                  task->job.record ? &task->record : nullptr));
+            }
+            if (!task->runner->step(slice))
+            {
+                size_t waitingHere;
+                {
+                    lock_guard<mutex> guard(own.lock);
+                    own.tasks.push_back(move(task));
+                    waitingHere = own.tasks.size();
+                }
+                queued++;
+                // A game that this thread will take next is no work for anyone else
+                if (waitingHere > 1)
+                {
+                    wakeOne();
+                }
+                continue;
+            }
+
+            if (task->onComplete)
+            {
+                task->onComplete(task->job, task->runner->getResult(), task->job.record ? &task->record : nullptr);
+            }
+            task.reset();
+            lock_guard<mutex> guard(lock);
+            active--;
+            if (--unfinished == 0)
+            {
+                allDone.notify_all();
+            }
+            if (!waiting.empty() && sleeping > 0)
+            {
+                workReady.notify_one();
+            }
+        }
+    }
+}
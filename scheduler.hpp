@@ -0,0 +1,106 @@
+#ifndef SCHEDULER_HPP
+#define SCHEDULER_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "simulation.hpp"
+
+using namespace std;
+
+namespace ariel
+{
+
+    // One game to be played by the scheduler
+    struct GameJob
+    {
+        uint64_t seed;        // Seed of the board, the dice and the bots
+        vector<string> bots;  // Strategy of every seat, as accepted by createBot
+        int maxTurns;         // Turns after which the game is abandoned
+        bool record;          // Whether to keep a record of the game
+
+        GameJob() : seed(0), maxTurns(1000), record(false) {}
+        GameJob(uint64_t seed, const vector<string> &bots, int maxTurns = 1000, bool record = false)
+            : seed(seed), bots(bots), maxTurns(maxTurns), record(record) {}
+    };
+
+    // Called on a worker thread when a game is over; the record is null unless the job asked for one
+    typedef function<void(const GameJob &job, const GameResult &result, const GameRecord *record)> GameCallback;
+
+    // Plays many independent games on a fixed pool of threads. Games are played a slice
+    // of bot decisions at a time and then go to the back of their thread's queue, so
+    // thousands of games share the cores fairly without a thread each. A thread whose
+    // queue runs dry starts a new game or steals one from another thread, which keeps
+    // every core busy however unevenly the games run. Only a bounded number of games is
+    // in play at once; the rest wait as jobs and cost no more than their description.
+    // Every game owns its board, dice and bots, so the threads share nothing but the
+    // queues, and a thread only touches the shared ones to start or finish a game.
+    class GameScheduler
+    {
+    private:
+        struct Task;
+
+        // Games of one thread between slices: the owner takes the oldest, thieves the newest
+        struct WorkQueue
+        {
+            mutex lock;
+            deque<unique_ptr<Task>> tasks;
+        };
+
+        long slice;
+        size_t maxActive;
+        vector<unique_ptr<WorkQueue>> queues; // One per thread
+        atomic<size_t> queued;                // Games in all the thread queues
+        atomic<unsigned> sleeping;            // Threads waiting for work
+
+        mutable mutex lock; // Guards everything below
+        condition_variable workReady;
+        condition_variable allDone;
+        deque<unique_ptr<Task>> waiting; // Submitted and not started
+        size_t active;                   // Started and not finished
+        size_t unfinished;               // Submitted and not finished
+        bool stopping;
+        vector<thread> workers;
+
+        void work(size_t self);
+        unique_ptr<Task> takeOwn(size_t self);
+        unique_ptr<Task> startNext();
+        unique_ptr<Task> steal(size_t self);
+        bool sleep();
+        void wakeOne();
+
+    public:
+        // A pool of the given number of threads (0 for one per core) that plays games
+        // a slice of decisions at a time, with at most maxActive games started at once
+        // (0 for 64 per thread)
+        explicit GameScheduler(unsigned numOfThreads = 0, long slice = 64, size_t maxActive = 0);
+
+        // Waits for every submitted game, then stops the threads
+        ~GameScheduler();
+
+        GameScheduler(const GameScheduler &) = delete;
+        GameScheduler &operator=(const GameScheduler &) = delete;
+
+        // Queues a game; the callback, if any, runs on a worker thread when it is over.
+        // Throws invalid_argument for an unknown bot or an unsupported number of seats.
+        void submit(const GameJob &job, GameCallback onComplete = GameCallback());
+
+        // Blocks until every game submitted so far is over
+        void wait();
+
+        // Games submitted and not yet over
+        size_t pending() const;
+
+        unsigned numOfThreads() const { return (unsigned)workers.size(); }
+    };
+}
+
+#endif
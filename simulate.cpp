@@ -0,0 +1,253 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <memory>
+#include <stdexcept>
+
+#include "simulation.hpp"
+#include "scheduler.hpp"
+#include "log.hpp"
+#include "metrics.hpp"
+
+using namespace std;
+using namespace ariel;
+
+// Totals over the games played
+struct Statistics
+{
+    long games = 0;
+    long finished = 0;
+    long turns = 0;
+    vector<long> wins;
+    array<long, NUM_RESOURCES> produced = {};
+
+    void add(const GameResult &result)
+    {
+        games++;
+        if (result.winner >= 0)
+        {
+            finished++;
+            turns += result.turns;
+            wins[(size_t)result.winner]++;
+        }
+        for (size_t r = 0; r < NUM_RESOURCES; r++)
+        {
+            produced[r] += result.produced[r];
+        }
+    }
+};
+
+// Splits a comma separated list of bot names
+vector<string> splitNames(const string &list)
+{
+    vector<string> names;
+    size_t start = 0;
+    while (start <= list.size())
+    {
+        size_t end = list.find(',', start);
+        if (end == string::npos)
+        {
+            end = list.size();
+        }
+        names.push_back(list.substr(start, end - start));
+        start = end + 1;
+    }
+    return names;
+}
+
+void usage()
+{
+    cerr << "Usage: simulate [--games N] [--threads T] [--seed S] [--bots a,b,c,...] [--max-turns M] [--record FILE]" << endl;
+    cerr << "                [--log FILE] [--log-level trace|debug|info|warn|error] [--metrics]" << endl;
+    cerr << "Bots: random, greedy, mcts" << endl;
+    exit(1);
+}
+
+/**
+ * Plays many complete games between bots on all cores and prints aggregate statistics:
+ * win rate by seat, average game length and the share of each resource produced.
+ * Game i uses seed + i, so a run is reproducible from its seed regardless of the thread count.
+ * With --record, every game is appended to a binary archive that the replay tool can read.
+ * With --log, engine messages are appended to a file; levels below CATAN_LOG_LEVEL are
+ * compiled out, so debug messages need a build with make CATAN_LOG_LEVEL=1.
+ * With --metrics, the engine's event counters and per-action latency percentiles are printed too.
+ */
+int main(int argc, char *argv[])
+{
+    long numOfGames = 10000;
+    unsigned numOfThreads = thread::hardware_concurrency();
+    uint64_t seed = Rng::randomSeed();
+    string botList = "greedy,greedy,greedy";
+    int maxTurns = 500;
+    string recordPath;
+    string logPath;
+    LogLevel logLevel = LogLevel::Info;
+    bool metrics = false;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--metrics") == 0)
+        {
+            metrics = true;
+            continue;
+        }
+        if (i + 1 >= argc)
+        {
+            usage();
+        }
+        if (strcmp(argv[i], "--games") == 0)
+        {
+            numOfGames = atol(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--threads") == 0)
+        {
+            numOfThreads = (unsigned)atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--seed") == 0)
+        {
+            seed = strtoull(argv[++i], nullptr, 10);
+        }
+        else if (strcmp(argv[i], "--bots") == 0)
+        {
+            botList = argv[++i];
+        }
+        else if (strcmp(argv[i], "--max-turns") == 0)
+        {
+            maxTurns = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--record") == 0)
+        {
+            recordPath = argv[++i];
+        }
+        else if (strcmp(argv[i], "--log") == 0)
+        {
+            logPath = argv[++i];
+        }
+        else if (strcmp(argv[i], "--log-level") == 0)
+        {
+            try
+            {
+                logLevel = parseLevel(argv[++i]);
+            }
+            catch (const invalid_argument &error)
+            {
+                cerr << error.what() << endl;
+                usage();
+            }
+        }
+        else
+        {
+            usage();
+        }
+    }
+    if (numOfThreads == 0)
+    {
+        numOfThreads = 1;
+    }
+
+    vector<string> botNames = splitNames(botList);
+    if (botNames.size() < MIN_PLAYERS || botNames.size() > MAX_PLAYERS)
+    {
+        cerr << "Between " << MIN_PLAYERS << " and " << MAX_PLAYERS << " bots are needed, one per seat" << endl;
+        usage();
+    }
+    for (const string &name : botNames)
+    {
+        if (!createBot(name))
+        {
+            cerr << "Unknown bot: " << name << endl;
+            usage();
+        }
+    }
+
+    // Records are written in the order the games finish; each one carries its own seed
+    ofstream archive;
+    if (!recordPath.empty())
+    {
+        archive.open(recordPath, ios::binary);
+        if (!archive)
+        {
+            cerr << "Cannot write " << recordPath << endl;
+            return 1;
+        }
+    }
+
+    // The engine stays silent unless a log file is given
+    unique_ptr<FileSink> logSink;
+    if (!logPath.empty())
+    {
+        try
+        {
+            logSink.reset(new FileSink(logPath));
+        }
+        catch (const runtime_error &error)
+        {
+            cerr << error.what() << endl;
+            return 1;
+        }
+        Logger::setLevel(logLevel);
+        Logger::setSink(logSink.get());
+    }
+
+    Metrics::setEnabled(metrics);
+
+    // The scheduler interleaves the games on its threads; results are added up as games finish
+    Statistics total;
+    total.wins.assign(botNames.size(), 0);
+    mutex totalLock;
+    auto start = chrono::steady_clock::now();
+    {
+        GameScheduler scheduler(numOfThreads);
+        for (long game = 0; game < numOfGames; game++)
+        {
+            GameJob job(seed + (uint64_t)game, botNames, maxTurns, archive.is_open());
+            scheduler.submit(job, [&](const GameJob &, const GameResult &result, const GameRecord *record)
+                             {
+                lock_guard<mutex> guard(totalLock);
+                total.add(result);
+                if (record)
+                {
+                    record->write(archive);
+                } });
+        }
+        scheduler.wait();
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    Logger::setSink(nullptr);
+
+    cout << fixed << setprecision(2);
+    cout << "Games:      " << total.games << " (seed " << seed << ", " << numOfThreads << " threads)" << endl;
+    cout << "Finished:   " << total.finished << endl;
+    cout << "Avg turns:  " << (total.finished ? (double)total.turns / (double)total.finished : 0.0) << endl;
+    cout << "Win rate by seat:" << endl;
+    for (size_t i = 0; i < botNames.size(); i++)
+    {
+        double rate = total.games ? 100.0 * (double)total.wins[i] / (double)total.games : 0.0;
+        cout << "  Seat " << i + 1 << " (" << botNames[i] << "): " << rate << "%" << endl;
+    }
+    long totalProduced = 0;
+    for (long amount : total.produced)
+    {
+        totalProduced += amount;
+    }
+    cout << "Resources produced per game:" << endl;
+    for (size_t r = 0; r < NUM_RESOURCES; r++)
+    {
+        double perGame = total.games ? (double)total.produced[r] / (double)total.games : 0.0;
+        double share = totalProduced ? 100.0 * (double)total.produced[r] / (double)totalProduced : 0.0;
+        cout << "  " << setw(6) << left << resourceName((Resource)r) << right << " " << perGame << " (" << share << "%)" << endl;
+    }
+    cout << "Games/sec:  " << (seconds > 0 ? (double)total.games / seconds : 0.0) << endl;
+    if (metrics)
+    {
+        cout << Metrics::report(Metrics::snapshot());
+    }
+    return 0;
+}
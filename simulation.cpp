@@ -0,0 +1,219 @@
+#include "simulation.hpp"
+
+#include <climits>
+
+namespace ariel
+{
+
+    // Places one free settlement and the road next to it for the current player
+    static void placeSetupPieces(Catan &game, Bot &bot, Rng &rng)
+    {
+        Player &player = game.getCurrentPlayer();
+
+        // Fall back to the first legal choice if the bot picks an illegal one
+        int settlement = bot.chooseSetupSettlement(game, rng);
+        if (game.apply(Action::placeSettlement(settlement)) != ActionResult::Success)
+        {
+            vector<int> options = legalSettlements(game, player, true);
+            if (options.empty())
+            {
+                return;
+            }
+            settlement = options[0];
+            game.apply(Action::placeSettlement(settlement));
+        }
+
+        int road = bot.chooseSetupRoad(game, settlement, rng);
+        if (game.apply(Action::placeRoad(road)) != ActionResult::Success)
+        {
+            for (int edgeId : game.getBoard().getVertexEdges(settlement))
+            {
+                if (game.apply(Action::placeRoad(edgeId)) == ActionResult::Success)
+                {
+                    break;
+                }
+            }
+        }
+    }
+
+    /**
+     * Plays the setup rounds: every player places a settlement and a road, in the
+     * snake order of SetupSchedule. The game ends with seat 0 to move.
+     *
+     * @param game The game, with seat 0 as the current player.
+     * @param bots The bot of every seat.
+     * @param rng The random number generator used by the bots.
+     */
+    void playSetup(Catan &game, const vector<Bot *> &bots, Rng &rng)
+    {
+        SetupSchedule schedule(game.getNumOfPlayers());
+        for (size_t step = 0; step < schedule.size(); step++)
+        {
+            placeSetupPieces(game, *bots[game.getCurrentPlayer().getId()], rng);
+            schedule.advance(game, step);
+        }
+    }
+
+    /**
+     * Plays the current player's turn. The dice are rolled first, then the bot
+     * chooses actions until it ends the turn, the game is won, or it runs out of
+     * actions. Rejected actions count against the limit so a confused bot cannot stall.
+     *
+     * @param game The game to play.
+     * @param bot The bot of the current player.
+     * @param rng The random number generator used by the bot.
+     */
+    void playTurn(Catan &game, Bot &bot, Rng &rng)
+    {
+        game.apply(Action::rollDice());
+        for (int i = 0; i < MAX_ACTIONS_PER_TURN && !game.isGameEnded(); i++)
+        {
+            Action action = bot.chooseAction(game, rng);
+            if (action.type == ActionType::EndTurn)
+            {
+                break;
+            }
+            game.apply(action);
+        }
+        game.endTurn();
+    }
+
+    static vector<Player> seatsFor(size_t numOfSeats)
+    {
+        vector<Player> seats;
+        for (size_t i = 0; i < numOfSeats; i++)
+        {
+            seats.push_back(Player("Seat " + to_string(i + 1)));
+        }
+        return seats;
+    }
+
+    /**
+     * Sets up a game between bots without playing any of it.
+     *
+     * The board, the dice and the bots all draw from generators derived from the
+     * seed, so the same seed and bots always give the same game.
+     *
+     * @param bots The bot of every seat, one per player; seat 0 starts.
+     * @param seed The seed of the game.
+     * @param maxTurns The number of turns after which the game is abandoned.
+     * @param record If not null, receives the record of the game.
+     */
+    GameRunner::GameRunner(const vector<Bot *> &bots, uint64_t seed, int maxTurns, GameRecord *record)
+        : bots(bots), maxTurns(maxTurns), game(seatsFor(bots.size()), seed), rng(~seed), record(record),
+          phase(Phase::Setup), setupStep(0), turnActions(0)
+    {
+        result.winner = -1;
+        result.turns = 0;
+        if (record)
+        {
+            *record = GameRecord(game);
+            game.setRecord(record);
+        }
+    }
+
+    /**
+     * Advances the game one bot decision at a time, in the order of playSetup and
+     * playTurn: a setup placement counts as one decision, and so does every action a
+     * bot is asked for during a turn, including the one that ends it.
+     *
+     * @param decisions The number of decisions to play before yielding.
+     * @return Whether the game is over.
+     */
+    bool GameRunner::step(long decisions)
+    {
+        while (phase != Phase::Finished && decisions > 0)
+        {
+            switch (phase)
+            {
+            case Phase::Setup:
+            {
+                SetupSchedule schedule(game.getNumOfPlayers());
+                placeSetupPieces(game, *bots[game.getCurrentPlayer().getId()], rng);
+                schedule.advance(game, setupStep);
+                decisions--;
+                if (++setupStep == schedule.size())
+                {
+                    phase = Phase::TurnStart;
+                }
+                break;
+            }
+            case Phase::TurnStart:
+                if (result.turns >= maxTurns || game.isGameEnded())
+                {
+                    finish();
+                    break;
+                }
+                game.apply(Action::rollDice());
+                turnActions = 0;
+                phase = Phase::InTurn;
+                break;
+            case Phase::InTurn:
+            {
+                bool ended = turnActions >= MAX_ACTIONS_PER_TURN || game.isGameEnded();
+                if (!ended)
+                {
+                    Action action = bots[game.getCurrentPlayer().getId()]->chooseAction(game, rng);
+                    decisions--;
+                    turnActions++;
+                    ended = action.type == ActionType::EndTurn;
+                    if (!ended)
+                    {
+                        game.apply(action);
+                    }
+                }
+                if (ended)
+                {
+                    game.endTurn();
+                    result.turns++;
+                    phase = Phase::TurnStart;
+                }
+                break;
+            }
+            case Phase::Finished:
+                break;
+            }
+        }
+        // A game whose last decision won it is over without another call
+        if (phase == Phase::TurnStart && (result.turns >= maxTurns || game.isGameEnded()))
+        {
+            finish();
+        }
+        return phase == Phase::Finished;
+    }
+
+    void GameRunner::finish()
+    {
+        for (size_t i = 0; i < game.getNumOfPlayers(); i++)
+        {
+            int points = game.getPlayer(i).getPoints();
+            result.points.push_back(points);
+            if (points >= 10 && result.winner < 0)
+            {
+                result.winner = (int)i;
+            }
+        }
+        result.produced = game.getProducedResources();
+        if (record)
+        {
+            record->finish(game);
+        }
+        phase = Phase::Finished;
+    }
+
+    /**
+     * Plays a complete game between bots without any I/O.
+     *
+     * @param bots The bot of every seat, one per player; seat 0 starts.
+     * @param seed The seed of the game.
+     * @param maxTurns The number of turns after which the game is abandoned.
+     * @param record If not null, receives the record of the game.
+     * @return The winner, length, final points and production of the game.
+     */
+    GameResult playGame(const vector<Bot *> &bots, uint64_t seed, int maxTurns, GameRecord *record)
+    {
+        GameRunner runner(bots, seed, maxTurns, record);
+        runner.step(LONG_MAX);
+        return runner.getResult();
+    }
+}
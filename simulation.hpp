@@ -0,0 +1,82 @@
+#ifndef SIMULATION_HPP
+#define SIMULATION_HPP
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "catan.hpp"
+#include "bot.hpp"
+#include "record.hpp"
+
+using namespace std;
+
+namespace ariel
+{
+
+    // Upper bound on the actions a bot may take in a single turn
+    const int MAX_ACTIONS_PER_TURN = 50;
+
+    // The outcome of one simulated game
+    struct GameResult
+    {
+        int winner;                         // Seat of the winner, or -1 if the turn limit was hit
+        int turns;                          // Turns played after the setup rounds
+        vector<int> points;                 // Final points per seat
+        array<int, NUM_RESOURCES> produced; // Resources handed out by dice rolls, per type
+    };
+
+    // Places the two free settlements and roads of every player in snake order
+    void playSetup(Catan &game, const vector<Bot *> &bots, Rng &rng);
+
+    // Plays the current player's turn: rolls the dice, then applies bot actions until the turn ends
+    void playTurn(Catan &game, Bot &bot, Rng &rng);
+
+    // A game between bots that is played a few decisions at a time, so a scheduler can
+    // interleave many games on a few threads. Every bot decision is a point where the game
+    // can stop and later resume, on the same thread or another one, with the same outcome
+    // as playing it through in one go.
+    class GameRunner
+    {
+    private:
+        enum class Phase
+        {
+            Setup,     // Placing the free settlements and roads
+            TurnStart, // About to roll the dice for the next turn
+            InTurn,    // Asking the current bot for actions
+            Finished
+        };
+
+        vector<Bot *> bots;
+        int maxTurns;
+        Catan game;
+        Rng rng;
+        GameRecord *record;
+        Phase phase;
+        size_t setupStep;
+        int turnActions; // Actions asked for in the current turn
+        GameResult result;
+
+        void finish();
+
+    public:
+        // bots[i] plays seat i and seat 0 starts. If a record is given, it is overwritten
+        // with the record of the game. The bots and the record must outlive the runner.
+        GameRunner(const vector<Bot *> &bots, uint64_t seed, int maxTurns, GameRecord *record = nullptr);
+
+        // Plays until the game is over or the bots have made the given number of decisions;
+        // returns whether the game is over
+        bool step(long decisions);
+
+        bool isFinished() const { return phase == Phase::Finished; }
+
+        // The outcome, once the game is over
+        const GameResult &getResult() const { return result; }
+    };
+
+    // Plays a complete game between the bots, one seat per bot; bots[i] plays seat i and seat 0 starts.
+    // If a record is given, it is overwritten with the record of the game.
+    GameResult playGame(const vector<Bot *> &bots, uint64_t seed, int maxTurns, GameRecord *record = nullptr);
+}
+
+#endif
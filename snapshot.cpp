@@ -0,0 +1,172 @@
+#include "snapshot.hpp"
+
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace ariel
+{
+
+    static const char MAGIC[4] = {'C', 'T', 'N', 'S'};
+
+    // The header of a file written on this machine, with no states yet
+    static SnapshotHeader localHeader()
+    {
+        SnapshotHeader header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.byteOrder = SNAPSHOT_BYTE_ORDER;
+        header.version = SNAPSHOT_VERSION;
+        header.stateSize = (uint32_t)sizeof(GameState);
+        header.playerSize = (uint32_t)sizeof(PlayerState);
+        header.maxPlayers = (uint16_t)GameState::MAX_PLAYERS;
+        header.numTiles = (uint16_t)NUM_TILES;
+        header.numVertices = (uint16_t)NUM_VERTICES;
+        header.numEdges = (uint16_t)NUM_EDGES;
+        return header;
+    }
+
+    SnapshotWriter::SnapshotWriter(const string &path) : out(path, ios::binary | ios::trunc), path(path), count(0)
+    {
+        if (!out)
+        {
+            throw runtime_error("Cannot write " + path);
+        }
+        SnapshotHeader header = localHeader();
+        out.write((const char *)&header, sizeof(header));
+        if (!out)
+        {
+            throw runtime_error("Cannot write " + path);
+        }
+    }
+
+    SnapshotWriter::~SnapshotWriter()
+    {
+        if (out.is_open())
+        {
+            try
+            {
+                close();
+            }
+            catch (const runtime_error &)
+            {
+            }
+        }
+    }
+
+    void SnapshotWriter::write(const GameState &state)
+    {
+        out.write((const char *)&state, sizeof(GameState));
+        if (!out)
+        {
+            throw runtime_error("Cannot write " + path);
+        }
+        count++;
+    }
+
+    void SnapshotWriter::close()
+    {
+        out.seekp((streamoff)offsetof(SnapshotHeader, count));
+        out.write((const char *)&count, sizeof(count));
+        if (!out)
+        {
+            out.close();
+            throw runtime_error("Cannot write " + path);
+        }
+        out.close();
+        if (out.fail())
+        {
+            throw runtime_error("Cannot write " + path);
+        }
+    }
+
+    void saveSnapshots(const string &path, const vector<GameState> &states)
+    {
+        SnapshotWriter writer(path);
+        for (const GameState &state : states)
+        {
+            writer.write(state);
+        }
+        writer.close();
+    }
+
+    /**
+     * Maps a snapshot file into memory. Only the header is read, to check that the file
+     * holds states of the layout this program uses and that all of them are there.
+     *
+     * @param path The file to open.
+     * @throws runtime_error if the file cannot be read or does not match.
+     */
+    SnapshotFile::SnapshotFile(const string &path) : data(nullptr), length(0), states(nullptr), count(0)
+    {
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            throw runtime_error("Cannot read " + path);
+        }
+        struct stat info;
+        if (fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(SnapshotHeader))
+        {
+            ::close(fd);
+            throw runtime_error(path + " is not a snapshot file");
+        }
+        length = (size_t)info.st_size;
+        void *mapped = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (mapped == MAP_FAILED)
+        {
+            throw runtime_error("Cannot map " + path);
+        }
+        data = mapped;
+
+        const SnapshotHeader &header = *(const SnapshotHeader *)data;
+        SnapshotHeader expected = localHeader();
+        string problem;
+        if (memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0)
+        {
+            problem = " is not a snapshot file";
+        }
+        else if (header.byteOrder != expected.byteOrder || header.version != expected.version)
+        {
+            problem = " was written by an incompatible version or machine";
+        }
+        else if (header.stateSize != expected.stateSize || header.playerSize != expected.playerSize ||
+                 header.maxPlayers != expected.maxPlayers || header.numTiles != expected.numTiles ||
+                 header.numVertices != expected.numVertices || header.numEdges != expected.numEdges)
+        {
+            problem = " holds states of a different layout";
+        }
+        else if (header.count > (length - sizeof(SnapshotHeader)) / sizeof(GameState) ||
+                 length != sizeof(SnapshotHeader) + header.count * sizeof(GameState))
+        {
+            problem = " is truncated or was not closed";
+        }
+        if (!problem.empty())
+        {
+            munmap(mapped, length);
+            throw runtime_error(path + problem);
+        }
+
+        count = (size_t)header.count;
+        states = (const GameState *)((const char *)data + sizeof(SnapshotHeader));
+    }
+
+    SnapshotFile::~SnapshotFile()
+    {
+        munmap(const_cast<void *>(data), length);
+    }
+
+    const GameState &SnapshotFile::at(size_t index) const
+    {
+        if (index >= count)
+        {
+            throw out_of_range("No state " + to_string(index) + " in a snapshot of " + to_string(count));
+        }
+        return states[index];
+    }
+}
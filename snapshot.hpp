@@ -0,0 +1,107 @@
+#ifndef SNAPSHOT_HPP
+#define SNAPSHOT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "gamestate.hpp"
+
+using namespace std;
+
+namespace ariel
+{
+
+    // Start of a snapshot file. The sizes and counts describe the layout of GameState
+    // on the machine that wrote the file; a file is only opened where they all match,
+    // so the states can be used in place without being converted.
+    struct SnapshotHeader
+    {
+        char magic[4];        // "CTNS"
+        uint32_t byteOrder;   // SNAPSHOT_BYTE_ORDER as the writer stored it
+        uint32_t version;     // SNAPSHOT_VERSION
+        uint32_t stateSize;   // sizeof(GameState)
+        uint32_t playerSize;  // sizeof(PlayerState)
+        uint16_t maxPlayers;  // GameState::MAX_PLAYERS
+        uint16_t numTiles;    // NUM_TILES
+        uint16_t numVertices; // NUM_VERTICES
+        uint16_t numEdges;    // NUM_EDGES
+        uint32_t reserved;
+        uint64_t count;       // Number of states that follow
+        uint8_t padding[24];  // Keeps the states aligned to a cache line
+    };
+
+    static_assert(sizeof(SnapshotHeader) == 64, "SnapshotHeader must take one cache line");
+    static_assert(64 % alignof(GameState) == 0, "The states after the header must be aligned");
+
+    const uint32_t SNAPSHOT_VERSION = 1;
+    const uint32_t SNAPSHOT_BYTE_ORDER = 0x01020304;
+
+    // Writes game states to a snapshot file: the header, then every state byte for
+    // byte as it is in memory. The count in the header is filled in when the file is
+    // closed, so a file that was not closed cannot be opened.
+    class SnapshotWriter
+    {
+    private:
+        ofstream out;
+        string path;
+        uint64_t count;
+
+    public:
+        // Creates or truncates the file; throws runtime_error if it cannot be written
+        explicit SnapshotWriter(const string &path);
+
+        // Closes the file if close was not called. A failure here cannot be reported,
+        // so call close to find out whether the file is complete.
+        ~SnapshotWriter();
+
+        SnapshotWriter(const SnapshotWriter &) = delete;
+        SnapshotWriter &operator=(const SnapshotWriter &) = delete;
+
+        // Appends a state; throws runtime_error if it cannot be written
+        void write(const GameState &state);
+
+        // Writes the count and closes the file; throws runtime_error if it fails
+        void close();
+
+        size_t size() const { return (size_t)count; }
+    };
+
+    // A snapshot file mapped read-only into memory. Opening it checks the header and
+    // the file size and reads nothing else; the states are used where they lie, and the
+    // operating system pages them in as they are touched.
+    class SnapshotFile
+    {
+    private:
+        const void *data;
+        size_t length;
+        const GameState *states;
+        size_t count;
+
+    public:
+        // Maps the file; throws runtime_error if it cannot be read, is not a snapshot
+        // file, was written with a different GameState layout or is truncated
+        explicit SnapshotFile(const string &path);
+
+        ~SnapshotFile();
+
+        SnapshotFile(const SnapshotFile &) = delete;
+        SnapshotFile &operator=(const SnapshotFile &) = delete;
+
+        size_t size() const { return count; }
+        const GameState &operator[](size_t index) const { return states[index]; }
+
+        // Like operator[], but throws out_of_range for an index past the end
+        const GameState &at(size_t index) const;
+
+        const GameState *begin() const { return states; }
+        const GameState *end() const { return states + count; }
+    };
+
+    // Writes the states to a new snapshot file
+    void saveSnapshots(const string &path, const vector<GameState> &states);
+}
+
+#endif
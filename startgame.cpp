@@ -1,6 +1,8 @@
 #include <iostream>
 #include <stdexcept>
 #include <vector>
+#include <limits>
+#include <cstdlib>
 
 #include "player.hpp"
 #include "board.hpp"
@@ -10,19 +12,232 @@ using namespace std;
 using namespace ariel;
 
 /**
- * This function places initial structures (settlement and road) for a player on the game board.
+ * Reads an integer from the user, prompting again until a number is entered.
+ *
+ * @param prompt The message shown before reading.
+ * @return The number entered by the user.
+ */
+int readInt(const string &prompt)
+{
+    int value;
+    cout << prompt;
+    while (!(cin >> value))
+    {
+        // Stop the game if the input has ended
+        if (cin.eof())
+        {
+            exit(0);
+        }
+        cin.clear();
+        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+        cout << "Invalid input. " << prompt;
+    }
+    return value;
+}
+
+/**
+ * Reads a single word from the user.
+ *
+ * @param prompt The message shown before reading.
+ * @return The word entered by the user.
+ */
+string readWord(const string &prompt)
+{
+    string value;
+    cout << prompt;
+    if (!(cin >> value))
+    {
+        // Stop the game if the input has ended
+        exit(0);
+    }
+    return value;
+}
+
+/**
+ * Reads a resource name from the user.
+ *
+ * @param prompt The message shown before reading.
+ * @param resource Set to the resource that was entered.
+ * @return True if the user entered a known resource, false otherwise.
+ */
+bool readResource(const string &prompt, Resource &resource)
+{
+    if (parseResource(readWord(prompt), resource))
+    {
+        return true;
+    }
+    cout << "Unknown resource." << endl;
+    return false;
+}
+
+/**
+ * Prints the outcome of an action.
+ *
+ * @param result The result returned by the engine.
+ * @param successMessage The message to print when the action succeeded.
+ * @return True if the action succeeded.
+ */
+bool report(ActionResult result, const string &successMessage)
+{
+    if (result == ActionResult::Success)
+    {
+        cout << successMessage << endl;
+        return true;
+    }
+    cout << resultMessage(result) << endl;
+    return false;
+}
+
+/**
+ * Reads the name of another player and returns their seat index.
+ *
+ * @param catan A reference to the Catan game.
+ * @return The seat index, or -1 if there is no such player.
+ */
+int readOtherPlayer(Catan &catan)
+{
+    string name = readWord("Enter the name of the player you want to trade with: ");
+    return catan.findPlayerIndexByName(name);
+}
+
+/**
+ * This function places initial structures (settlement and road) for the current player on the game board.
+ * Both placements are retried until the engine accepts them.
  *
  * @param catan A reference to the Catan game.
- * @param player A reference to the player.
- * @param board A reference to the game board.
  */
-void placeInitialStructures(Catan &catan, Player &player, Board &board)
+void placeInitialStructures(Catan &catan)
 {
+    const string &name = catan.getCurrentPlayer().getName();
+
     // Place a settlement on the board for the player
-    catan.placeSettelemnt(player, board);
+    while (!report(catan.apply(Action::placeSettlement(readInt(name + ", enter where you want to place your settlement: "))),
+                   "Settlement placed successfully."))
+    {
+    }
 
     // Place a road on the board for the player
-    catan.placeRoad(player, board);
+    while (!report(catan.apply(Action::placeRoad(readInt(name + ", enter where you want to place your road: "))),
+                   "Road placed successfully."))
+    {
+    }
+}
+
+/**
+ * Asks the player which development card to play and plays it.
+ *
+ * @param catan A reference to the Catan game.
+ */
+void playDevelopmentCard(Catan &catan)
+{
+    if (catan.getCurrentPlayer().getAmountOfDevCards() == 0)
+    {
+        cout << "You do not have any development cards." << endl;
+        return;
+    }
+    cout << "Which development card do you want to play? (1-3): " << endl;
+    // Display available development cards
+    cout << "1. Year of Plenty" << endl;
+    cout << "2. Monopoly" << endl;
+    cout << "3. Road Building" << endl;
+    int choosenCard = readInt("Enter your choice: ");
+    // Validate user input
+    while (choosenCard < 1 || choosenCard > 3)
+    {
+        choosenCard = readInt("Invalid choice. Please enter a number between 1 and 3: ");
+    }
+
+    // Play the chosen development card
+    switch (choosenCard)
+    {
+    case 1:
+    {
+        Resource resource1, resource2;
+        if (readResource("Enter the first resource: ", resource1) && readResource("Enter the second resource: ", resource2))
+        {
+            report(catan.apply(Action::playYearOfPlenty(resource1, resource2)), "Year of plenty card played.");
+        }
+        break;
+    }
+    case 2:
+    {
+        Resource resource;
+        if (readResource("Enter the resource: ", resource))
+        {
+            report(catan.apply(Action::playMonopoly(resource)), "Resources taken successfully.");
+        }
+        break;
+    }
+    case 3:
+    {
+        int firstEdge = readInt("Enter where you want to place your first road: ");
+        int secondEdge = readInt("Enter where you want to place your second road: ");
+        report(catan.apply(Action::playRoadBuilding(firstEdge, secondEdge)), "Roads placed successfully.");
+        break;
+    }
+    }
+}
+
+/**
+ * Asks the player for the details of a trade and applies it.
+ *
+ * @param catan A reference to the Catan game.
+ */
+void trade(Catan &catan)
+{
+    // Prompt for trading a Knight card
+    string choice = readWord("Would you like to trade a Knight card? (y/n): ");
+
+    // If the player wants to trade a Knight card
+    if (choice == "y")
+    {
+        choice = readWord("Would you like to sell or buy a Knight card? (s/b): ");
+        if (choice != "s" && choice != "b")
+        {
+            cout << "Invalid choice." << endl;
+            return;
+        }
+        int other = readOtherPlayer(catan);
+        int numOfCards = readInt(choice == "s" ? "Enter the number of Knight cards you want to sell: "
+                                               : "Enter the number of Knight cards you want to buy: ");
+        Resource resource;
+        if (!readResource(choice == "s" ? "What resource do you want in return? "
+                                        : "What resource are you willing to pay? ",
+                          resource))
+        {
+            return;
+        }
+        int amount = readInt("How many " + resourceName(resource) + "? ");
+
+        if (choice == "s")
+        {
+            report(catan.apply(Action::sellKnight(other, numOfCards, resource, amount)), "Knight cards sold.");
+        }
+        else
+        {
+            report(catan.apply(Action::buyKnight(other, numOfCards, resource, amount)), "Knight cards bought.");
+        }
+        return;
+    }
+
+    // If the player wants to trade resources
+    int other = readOtherPlayer(catan);
+    Resource giveResource, receiveResource;
+    if (!readResource("Enter the resource you want to give: ", giveResource) ||
+        !readResource("Enter the resource you want to receive: ", receiveResource))
+    {
+        return;
+    }
+    int giveAmount = readInt("Enter the amount you want to give: ");
+    int receiveAmount = readInt("Enter the amount you want to receive: ");
+
+    // Perform the trade
+    if (report(catan.apply(Action::trade(other, giveResource, receiveResource, giveAmount, receiveAmount)),
+               "Trade completed successfully."))
+    {
+        cout << "your updated resources: " << endl;
+        catan.getCurrentPlayer().printResources();
+    }
 }
 
 /**
@@ -33,8 +248,7 @@ void placeInitialStructures(Catan &catan, Player &player, Board &board)
  */
 void playerTurn(Catan &catan, Board &board)
 {
-    int choice, location;
-    string name, giveResource, receiveResource;
+    int choice;
     Player &player = catan.getCurrentPlayer();
 
     // Loop until the player has ended their turn.
@@ -51,15 +265,11 @@ void playerTurn(Catan &catan, Board &board)
         cout << "8. Print board data" << endl;
         cout << "9. Print my resources" << endl;
 
-        // Prompt the player to choose an option.
-        cout << "Enter your choice: ";
-
-        // Validate the user input.
-        while (!(cin >> choice) || choice < 1 || choice > 9)
+        // Prompt the player to choose an option and validate the user input.
+        choice = readInt("Enter your choice: ");
+        while (choice < 1 || choice > 9)
         {
-            cin.clear();
-            cin.ignore(numeric_limits<streamsize>::max(), '\n');
-            cout << "Invalid choice. Please enter a number between 1 and 8: ";
+            choice = readInt("Invalid choice. Please enter a number between 1 and 9: ");
         }
 
         // Execute the chosen option.
@@ -67,43 +277,49 @@ void playerTurn(Catan &catan, Board &board)
         {
         case 1:
             // End the turn.
-            catan.endTurn();
+            catan.apply(Action::endTurn());
             cout << "--------------------------" << endl;
             break;
 
         case 2:
             // Build a road.
-            catan.placeRoad(player, board);
+            report(catan.apply(Action::placeRoad(readInt(player.getName() + ", enter where you want to place your road: "))),
+                   "Road placed successfully.");
             break;
 
         case 3:
             // Build a settlement.
-            catan.placeSettelemnt(player, board);
+            report(catan.apply(Action::placeSettlement(readInt(player.getName() + ", enter where you want to place your settlement: "))),
+                   "Settlement placed successfully.");
             break;
 
         case 4:
             // Upgrade a settlement to a city.
-            catan.upgradeSettlement(player, board);
+            report(catan.apply(Action::upgradeSettlement(readInt(player.getName() + ", enter where you want to upgrade your settlement: "))),
+                   "Settlement upgraded to city successfully.");
             break;
 
         case 5:
             // Buy a development card.
-            catan.buyDevelopmentCard(player);
+            if (report(catan.apply(Action::buyDevelopmentCard()), "You have bought a development card."))
+            {
+                cout << "You have bought a " << devCardName(catan.getLastDevelopmentCard()) << " card." << endl;
+            }
             break;
 
         case 6:
             // Play a development card.
-            catan.playDevelopmentCard(player);
+            playDevelopmentCard(catan);
             break;
 
         case 7:
             // Trade resources with another player.
-            catan.trade(player);
+            trade(catan);
             break;
 
         case 8:
             // Print the board data.
-            board.printBoard();
+            board.printBoard(catan.getPlayerNames());
             break;
         case 9:
             // Print the player's resources.
@@ -125,30 +341,32 @@ int main()
 {
     cout << "Welcome to Catan!" << endl;
 
-    // Get names of the players
-    cout << "Please enter the name of the first player: ";
-    string name1;
-    cin >> name1;
-
-    cout << "Please enter the name of the second player: ";
-    string name2;
-    cin >> name2;
-
-    cout << "Please enter the name of the third player: ";
-    string name3;
-    cin >> name3;
-
-    // Create players
-    Player p1(name1);
-    Player p2(name2);
-    Player p3(name3);
+    // Get the number and names of the players
+    int numOfPlayers = readInt("How many players are playing? ");
+    while (numOfPlayers < (int)MIN_PLAYERS || numOfPlayers > (int)MAX_PLAYERS)
+    {
+        numOfPlayers = readInt("Invalid number of players. How many players are playing? ");
+    }
+    vector<Player> players;
+    for (int i = 0; i < numOfPlayers; i++)
+    {
+        players.push_back(Player(readWord("Please enter the name of player " + to_string(i + 1) + ": ")));
+    }
 
     // Create Catan game
-    Catan catan(p1, p2, p3);
+    Catan catan(players);
     catan.ChooseStartingPlayer();
-    Board board = catan.getBoard();
+    Board &board = catan.getBoard();
+
+    // Print the order of the players to the console
+    cout << "The order of the players is: " << endl;
+    for (size_t i = 0; i < catan.getNumOfPlayers(); i++)
+    {
+        cout << catan.getPlayer(i).getName() << endl;
+    }
 
     // Display game instructions and board
+    board.printTiles();
     string commanda = "xdg-open edges-8.jpg";
     string commandb = "xdg-open vertices-7.jpg";
     system(commanda.c_str());
@@ -156,18 +374,13 @@ int main()
 
     cout << "Starting of the game. Every player places two settlements and two roads." << endl;
 
-    // Place initial structures
-    // order of the players: p1 -> p2 -> p3 -> p3 -> p2 -> p1 (p1 as a starting player)
-    placeInitialStructures(catan, catan.getCurrentPlayer(), board);
-    catan.nextPlayer();
-    placeInitialStructures(catan, catan.getCurrentPlayer(), board);
-    catan.nextPlayer();
-    placeInitialStructures(catan, catan.getCurrentPlayer(), board);
-    placeInitialStructures(catan, catan.getCurrentPlayer(), board);
-    catan.previousPlayer();
-    placeInitialStructures(catan, catan.getCurrentPlayer(), board);
-    catan.previousPlayer();
-    placeInitialStructures(catan, catan.getCurrentPlayer(), board);
+    // Place initial structures in snake order, e.g. p1 -> p2 -> p3 -> p3 -> p2 -> p1 (p1 as a starting player)
+    SetupSchedule schedule(catan.getNumOfPlayers());
+    for (size_t step = 0; step < schedule.size(); step++)
+    {
+        placeInitialStructures(catan);
+        schedule.advance(catan, step);
+    }
 
     // Start the game
     cout << endl;
@@ -180,7 +393,8 @@ int main()
     {
         // Print current player's turn information
         cout << "*** It's " << catan.getCurrentPlayer().getName() << "'s turn. ***" << endl << endl;
-        catan.rollDice(board);
+        catan.apply(Action::rollDice());
+        cout << "Dice result is: " << catan.getLastRoll() << endl;
         cout << "Your resources: " << endl;
         catan.getCurrentPlayer().printResources();
 
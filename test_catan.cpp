@@ -1,9 +1,24 @@
 #include "board.hpp"
 #include "player.hpp"
 #include "catan.hpp"
+#include "simulation.hpp"
+#include "scheduler.hpp"
+#include "rating.hpp"
+#include "snapshot.hpp"
+#include "gamestate.hpp"
+#include "mcts.hpp"
+#include "journal.hpp"
+#include "log.hpp"
+#include "alloctrack.hpp"
+#include "metrics.hpp"
+#include "evaluator.hpp"
 #include <iostream>
 #include <cassert>
 #include <sstream>
+#include <cmath>
+#include <algorithm>
+#include <cstdio>
+#include <unistd.h>
 
 using namespace std;
 using namespace ariel;
@@ -61,7 +76,7 @@ void test_board_isVertexOccupied()
     assert(!isOccupied);
 
     Player player("Alice");
-    vertex.setOwner(player.getName());
+    vertex.setOwner(player.getId());
     isOccupied = board.isVertexOccupied(vertex);
     assert(isOccupied);
 
@@ -93,7 +108,7 @@ void test_board_placeSettlementAtVertex()
     board.placeSettlementAtVertex(vertex, player);
 
     assert(vertex.getType() == "settlement");
-    assert(vertex.getOwner() == "Alice");
+    assert(vertex.getOwner() == player.getId());
 
     cout << "test_board_placeSettlementAtVertex passed." << endl;
 }
@@ -104,10 +119,10 @@ void test_board_placeRoad()
     board.initialize();
     Player player("Bob");
     Edge edge = board.getEdge(0);
-    edge.owner = "Bob";
+    edge.owner = player.getId();
     board.placeSettlement(0, player, true);
     bool result = board.placeRoad(edge.id, player);
-    bool name = (edge.owner == player.getName());
+    bool name = (board.getEdge(0).owner == player.getId());
 
     assert(result);
     assert(name);
@@ -120,11 +135,11 @@ void test_board_isEdgeOccupied()
     Board board;
     Player player("John");
     Edge edge = board.getEdge(0);
-    edge.owner = "John";
+    edge.owner = player.getId();
 
     assert(board.isEdgeOccupied(edge));
 
-    edge.owner = "";
+    edge.owner = NO_PLAYER;
     assert(!board.isEdgeOccupied(edge));
 
     cout << "test_board_isEdgeOccupied passed." << endl;
@@ -140,7 +155,7 @@ void test_board_upgradeSettlement()
     bool success = board.upgradeSettlement(0, player);
     assert(success);
 
-    Player player2("Bob");
+    Player player2("Bob", 1);
     success = board.upgradeSettlement(0, player2);
     assert(!success);
 
@@ -202,6 +217,152 @@ void test_board_isConnectedToPlayerSettlement()
     cout << "test_board_isConnectedToPlayerSettlement passed." << endl;
 }
 
+void test_board_bitboards()
+{
+    Board board;
+    Player alice("Alice", 0), bob("Bob", 1);
+    assert(board.getBuildingsMask().none());
+
+    board.placeSettlement(0, alice, true);
+    board.placeRoad(0, alice);
+    assert(board.getSettlementsMask(0) == VertexMask::single(0));
+    assert(board.getRoadsMask(0).test(0));
+    assert(board.getRoadsMask(1).none());
+    assert(board.isVertexOccupied(0) && !board.isVertexOccupied(1));
+    assert(board.isEdgeOccupied(0) && !board.isEdgeOccupied(1));
+
+    // Vertex 0 touches vertices 1 and 8
+    assert(board.getVertexNeighborMask(0).count() == 2);
+    assert(board.getVertexNeighborMask(0).test(1) && board.getVertexNeighborMask(0).test(8));
+    assert(board.hasAdjacentSettlement(board.getVertex(8)));
+
+    // The 72 edges span both words of an edge mask
+    EdgeMask edges;
+    edges.set(3);
+    edges.set(70);
+    vector<int> members;
+    edges.forEach([&](int e) { members.push_back(e); });
+    assert(members == vector<int>({3, 70}));
+
+    board.upgradeSettlement(0, alice);
+    assert(board.getSettlementsMask(0).none());
+    assert(board.getCitiesMask(0).test(0));
+    assert(board.isVertexOccupied(0));
+    assert(board.validateSettlement(1, bob, true) == ActionResult::AdjacentSettlement);
+
+    cout << "test_board_bitboards passed." << endl;
+}
+
+void test_board_topologyIsConsistent()
+{
+    Board board;
+    for (int e = 0; e < board.getEdgesSize(); e++)
+    {
+        // Both ends of an edge list it, and its neighbors are exactly the other edges at its ends
+        vector<int> expected;
+        for (int v : board.getEdgeVertices(e))
+        {
+            const IdList<3> &around = board.getVertexEdges(v);
+            assert(find(around.begin(), around.end(), e) != around.end());
+            for (int f : around)
+            {
+                if (f != e)
+                {
+                    expected.push_back(f);
+                }
+            }
+        }
+        vector<int> neighbors(board.getEdgeNeighbors(e).begin(), board.getEdgeNeighbors(e).end());
+        sort(expected.begin(), expected.end());
+        sort(neighbors.begin(), neighbors.end());
+        assert(neighbors == expected);
+    }
+    for (int v = 0; v < board.getVerticesSize(); v++)
+    {
+        for (int n : board.getVertexNeighbors(v))
+        {
+            const IdList<3> &back = board.getVertexNeighbors(n);
+            assert(find(back.begin(), back.end(), v) != back.end());
+        }
+    }
+
+    cout << "test_board_topologyIsConsistent passed." << endl;
+}
+
+// Checks a table of the standard board against the generated lists, entry by entry
+template <size_t N, size_t SIZE>
+static bool sameLists(const IdList<N> (&table)[SIZE], const vector<IdList<N, uint16_t>> &generated)
+{
+    if (generated.size() != SIZE)
+    {
+        return false;
+    }
+    for (size_t i = 0; i < SIZE; i++)
+    {
+        if (table[i].size() != generated[i].size() || !equal(table[i].begin(), table[i].end(), generated[i].begin()))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void test_board_generatedTopology()
+{
+    // The byte tables of the standard board hold the generated lists unchanged
+    const Topology &tables = standardTopology();
+    const HexTopology &standard = HexTopology::hexagon(STANDARD_RADIUS);
+    assert(sameLists(tables.vertexVertices, standard.vertexVertices));
+    assert(sameLists(tables.vertexEdges, standard.vertexEdges));
+    assert(sameLists(tables.vertexTiles, standard.vertexTiles));
+    assert(sameLists(tables.edgeVertices, standard.edgeVertices));
+    assert(sameLists(tables.edgeEdges, standard.edgeEdges));
+    assert(sameLists(tables.tileVertices, standard.tileVertices));
+    assert(sameLists(tables.tileEdges, standard.tileEdges));
+
+    // The standard board keeps the numbering used everywhere else
+    const IdList<6> &corners = tables.tileVertices[0];
+    assert(corners.size() == 6 && corners[0] == 0 && corners[2] == 2 && corners[3] == 8 && corners[5] == 10);
+    assert(tables.edgeVertices[6][0] == 0 && tables.edgeVertices[6][1] == 8);
+    assert(tables.edgeVertices[71][0] == 52 && tables.edgeVertices[71][1] == 53);
+    assert(tables.vertexTiles[9].size() == 3 && tables.vertexTiles[9][2] == 4);
+
+    // A hexagon of radius R has 3R^2 + 3R + 1 tiles, 6(R + 1)^2 vertices and 9R^2 + 15R + 6 edges
+    for (int radius = 0; radius <= 5; radius++)
+    {
+        const HexTopology &topology = HexTopology::hexagon(radius);
+        assert(topology.numTiles() == 3 * radius * radius + 3 * radius + 1);
+        assert(topology.numVertices() == 6 * (radius + 1) * (radius + 1));
+        assert(topology.numEdges() == 9 * radius * radius + 15 * radius + 6);
+        for (int e = 0; e < topology.numEdges(); e++)
+        {
+            for (int v : topology.edgeVertices[(size_t)e])
+            {
+                const HexTopology::List3 &around = topology.vertexEdges[(size_t)v];
+                assert(find(around.begin(), around.end(), e) != around.end());
+            }
+        }
+    }
+
+    // Shapes are cached whatever the order of their tiles
+    vector<HexCoord> shape = HexTopology::hexagonShape(3);
+    reverse(shape.begin(), shape.end());
+    assert(&HexTopology::forShape(shape) == &HexTopology::hexagon(3));
+    shape.push_back(shape[0]);
+    bool rejected = false;
+    try
+    {
+        HexTopology repeated(shape);
+    }
+    catch (const invalid_argument &)
+    {
+        rejected = true;
+    }
+    assert(rejected);
+
+    cout << "test_board_generatedTopology passed." << endl;
+}
+
 void test_player_getName()
 {
     Player player("Alice");
@@ -522,6 +683,1247 @@ void test_catan_buyDevelopmentCard()
     cout << "test_catan_buyDevelopmentCard passed." << endl;
 }
 
+void test_catan_applyPlaceSettlementAndRoad()
+{
+    Player p1("Alice"), p2("Bob"), p3("Charlie");
+    Catan game(p1, p2, p3);
+
+    // The first settlements are free and need no road
+    assert(game.apply(Action::placeSettlement(0)) == ActionResult::Success);
+    assert(game.getBoard().getVertex(0).getOwner() == 0);
+    assert(game.apply(Action::placeSettlement(1)) == ActionResult::AdjacentSettlement);
+    assert(game.apply(Action::placeSettlement(54)) == ActionResult::InvalidLocation);
+
+    // A road must touch one of the player's settlements
+    assert(game.apply(Action::placeRoad(30)) == ActionResult::NotConnected);
+    assert(game.apply(Action::placeRoad(0)) == ActionResult::Success);
+    assert(game.apply(Action::placeRoad(0)) == ActionResult::LocationOccupied);
+    assert(game.getCurrentPlayer().amountOfResources("brick") == 1);
+
+    cout << "test_catan_applyPlaceSettlementAndRoad passed." << endl;
+}
+
+void test_catan_applyTurnAndTrade()
+{
+    Player p1("Alice"), p2("Bob"), p3("Charlie");
+    Catan game(p1, p2, p3);
+
+    assert(game.apply(Action::trade(0, Resource::Brick, Resource::Lumber, 1, 1)) == ActionResult::InvalidPlayer);
+    assert(game.apply(Action::trade(1, Resource::Brick, Resource::Brick, 1, 1)) == ActionResult::InvalidTrade);
+    assert(game.apply(Action::trade(1, Resource::Brick, Resource::Ore, 1, 1)) == ActionResult::InsufficientResources);
+    assert(game.apply(Action::trade(1, Resource::Brick, Resource::Lumber, 2, 1)) == ActionResult::Success);
+    assert(game.getPlayer(0).amountOfResources("brick") == 0);
+    assert(game.getPlayer(0).amountOfResources("lumber") == 3);
+    assert(game.getPlayer(1).amountOfResources("brick") == 4);
+
+    // Knights are bought with a resource, never with a value outside the enum
+    game.getPlayer(1).addKnights(2);
+    assert(game.apply(Action::buyKnight(1, 1, (Resource)200, 1)) == ActionResult::InvalidTrade);
+    assert(game.apply(Action::buyKnight(1, 3, Resource::Lumber, 1)) == ActionResult::NoDevelopmentCard);
+    assert(game.apply(Action::buyKnight(1, 1, Resource::Lumber, 1)) == ActionResult::Success);
+    assert(game.getPlayer(0).amountOfKnights() == 1);
+    assert(game.getPlayer(0).amountOfResources("lumber") == 2);
+
+    assert(game.apply(Action::upgradeSettlement(0)) == ActionResult::InsufficientResources);
+    assert(game.apply(Action::playMonopoly(Resource::Wool)) == ActionResult::NoDevelopmentCard);
+
+    game.apply(Action::rollDice());
+    assert(game.getLastRoll() >= 2 && game.getLastRoll() <= 12);
+
+    assert(game.apply(Action::endTurn()) == ActionResult::Success);
+    assert(game.getCurrentPlayer().getName() == "Bob");
+
+    cout << "test_catan_applyTurnAndTrade passed." << endl;
+}
+
+void test_board_roadConnectsToRoad()
+{
+    Board board;
+    Player alice("Alice", 0), bob("Bob", 1);
+
+    board.placeSettlement(0, alice, true);
+    assert(board.placeRoad(0, alice));
+
+    // A road may extend another road of the same player, but not someone else's
+    assert(board.placeRoad(1, alice));
+    assert(!board.placeRoad(2, bob));
+    assert(board.isConnectedToPlayerRoad(board.getVertex(2), alice));
+    assert(!board.isConnectedToPlayerRoad(board.getVertex(2), bob));
+
+    cout << "test_board_roadConnectsToRoad passed." << endl;
+}
+
+void test_board_roadSupply()
+{
+    Board board;
+    Player alice("Alice", 0);
+    board.placeSettlement(0, alice, true);
+
+    // Every player builds at most MAX_ROADS roads
+    while (board.getRoadsLeft(0) > 0)
+    {
+        assert(board.placeRoad(board.getLegalRoads(0).first(), alice));
+    }
+    assert(board.getRoadsMask(0).count() == MAX_ROADS);
+    assert(board.getLegalRoads(0).none());
+    EdgeMask extensions;
+    board.getRoadsMask(0).forEach([&](int e) { extensions |= adjacencyMasks().edgeNeighbors[(size_t)e]; });
+    assert(board.validateRoad(extensions.without(board.getRoadsMask()).first(), alice) == ActionResult::NoRoadsLeft);
+
+    cout << "test_board_roadSupply passed." << endl;
+}
+
+void test_player_resourceArrays()
+{
+    Player player("Alice");
+    assert(player.amountOfResources(Resource::Brick) == 2);
+    assert(player.getTotalResources() == 4);
+
+    player.addResource(Resource::Wool, 1);
+    player.addResource(Resource::Grain, 1);
+    assert(player.hasEnoughResources(Purchase::Settlement));
+    assert(!player.hasEnoughResources(Purchase::City));
+
+    player.deductResources(Purchase::Settlement);
+    assert(player.amountOfResources("wool") == 0);
+    assert(player.getTotalResources() == 2);
+
+    // Unknown names at the string boundary are ignored
+    player.addResource("gold", 3);
+    assert(player.getTotalResources() == 2);
+
+    Resource resource;
+    assert(parseResource("ore", resource) && resource == Resource::Ore);
+    assert(!parseResource("Desert", resource));
+
+    player.addDevelopmentCard(DevCard::Monopoly);
+    assert(player.hasEnoughResources("monopoly"));
+    player.deductResources("monopoly");
+    assert(!player.hasDevelopmentCard(DevCard::Monopoly));
+
+    cout << "test_player_resourceArrays passed." << endl;
+}
+
+void test_board_giveResources()
+{
+    Board board;
+    Player alice("Alice", 0), bob("Bob", 1);
+    vector<Player> players = {alice, bob};
+
+    // Find a producing tile and build on two of its corners
+    int tileIndex = board.getTile(0).desert ? 1 : 0;
+    Tile &tile = board.getTile(tileIndex);
+    const IdList<6> &corners = board.getTileVertices(tileIndex);
+    board.placeSettlement(corners[0], players[0], true);
+    board.placeSettlement(corners[5], players[1], true);
+    assert(board.upgradeSettlement(corners[5], players[1]));
+
+    int aliceBefore = players[0].amountOfResources(tile.resource);
+    int bobBefore = players[1].amountOfResources(tile.resource);
+    board.produce(players, tile.number);
+    assert(players[0].amountOfResources(tile.resource) >= aliceBefore + 1);
+    assert(players[1].amountOfResources(tile.resource) >= bobBefore + 2);
+
+    // giveResources credits only the given player
+    bobBefore = players[1].amountOfResources(tile.resource);
+    board.giveResources(players[1], tile.number);
+    assert(players[1].amountOfResources(tile.resource) >= bobBefore + 2);
+    assert(board.getProduction(7).empty());
+
+    cout << "test_board_giveResources passed." << endl;
+}
+
+void test_catan_seededGamesAreReproducible()
+{
+    Player p1("Alice"), p2("Bob"), p3("Charlie");
+    Catan first(p1, p2, p3, 42), second(p1, p2, p3, 42);
+    assert(first.getSeed() == 42);
+
+    for (int i = 0; i < 19; i++)
+    {
+        assert(first.getBoard().getTile(i).type == second.getBoard().getTile(i).type);
+    }
+
+    first.ChooseStartingPlayer();
+    second.ChooseStartingPlayer();
+    assert(first.getCurrentPlayer().getName() == second.getCurrentPlayer().getName());
+
+    for (int i = 0; i < 50; i++)
+    {
+        first.apply(Action::rollDice());
+        second.apply(Action::rollDice());
+        assert(first.getLastRoll() == second.getLastRoll());
+        assert(first.getLastRoll() >= 2 && first.getLastRoll() <= 12);
+    }
+
+    cout << "test_catan_seededGamesAreReproducible passed." << endl;
+}
+
+// Computes the Zobrist hash of a game from scratch, for comparison with the incremental one
+uint64_t hashFromScratch(Catan &game)
+{
+    Board &board = game.getBoard();
+    uint64_t hash = 0;
+    for (size_t i = 0; i < game.getNumOfPlayers(); i++)
+    {
+        Player &player = game.getPlayer(i);
+        uint8_t id = player.getId();
+        board.getSettlementsMask(id).forEach([&](int v) { hash ^= zobrist::settlement(v, id); });
+        board.getCitiesMask(id).forEach([&](int v) { hash ^= zobrist::city(v, id); });
+        board.getRoadsMask(id).forEach([&](int e) { hash ^= zobrist::road(e, id); });
+        for (size_t r = 0; r < NUM_RESOURCES; r++)
+        {
+            hash ^= zobrist::resource(id, r, player.amountOfResources((Resource)r));
+        }
+        for (size_t c = 0; c < NUM_DEV_CARDS; c++)
+        {
+            hash ^= zobrist::devCard(id, c, player.amountOfDevelopmentCards((DevCard)c));
+        }
+    }
+    GameState state(game);
+    hash ^= zobrist::knightsLeft(state.knightsLeft);
+    hash ^= zobrist::victoryPointsLeft(state.VPleft);
+    hash ^= zobrist::currentPlayer(state.currentPlayer);
+    hash ^= zobrist::longestRoad(state.longestRoadHolder);
+    return hash;
+}
+
+void test_catan_incrementalHash()
+{
+    Player p1("Alice"), p2("Bob"), p3("Charlie");
+    Catan game(p1, p2, p3, 31);
+    RandomBot bot;
+    vector<Bot *> bots = {&bot, &bot, &bot};
+    Rng rng(8);
+    assert(game.getHash() == hashFromScratch(game));
+
+    // The incremental hash matches a full recomputation after every action
+    playSetup(game, bots, rng);
+    assert(game.getHash() == hashFromScratch(game));
+    for (int step = 0; step < 3000 && !game.isGameEnded(); step++)
+    {
+        uint64_t before = game.getHash();
+        Action action = rng.below(3) ? bot.chooseAction(game, rng) : Action::rollDice();
+        ActionResult result = game.apply(action);
+        assert(game.getHash() == hashFromScratch(game));
+        if (result != ActionResult::Success)
+        {
+            assert(game.getHash() == before);
+        }
+    }
+
+    // A restored copy of the position has the same hash
+    Player q1("Dan"), q2("Eve"), q3("Frank");
+    Catan other(q1, q2, q3, 5);
+    assert(other.getHash() != game.getHash());
+    GameState(game).restore(other);
+    assert(other.getHash() == game.getHash());
+
+    cout << "test_catan_incrementalHash passed." << endl;
+}
+
+void test_catan_undoRedo()
+{
+    Player p1("Alice"), p2("Bob"), p3("Charlie");
+    Catan game(p1, p2, p3, 606);
+    RandomBot bot;
+    Rng rng(21);
+    Journal journal;
+    game.setJournal(&journal);
+    GameState start(game);
+
+    // Every move is taken back exactly, and redone to the same position
+    vector<Bot *> bots = {&bot, &bot, &bot};
+    playSetup(game, bots, rng);
+    for (int step = 0; step < 2000 && !game.isGameEnded(); step++)
+    {
+        GameState before(game);
+        uint64_t hash = game.getHash();
+        Action action = rng.below(3) ? bot.chooseAction(game, rng) : Action::rollDice();
+        if (game.apply(action) != ActionResult::Success)
+        {
+            assert(GameState(game) == before);
+            continue;
+        }
+        GameState after(game);
+        assert(game.undo());
+        assert(GameState(game) == before);
+        assert(game.getHash() == hash);
+        assert(game.redo());
+        assert(GameState(game) == after);
+        assert(!game.redo());
+    }
+
+    // Unwinding the whole history returns to the empty board
+    while (game.undo())
+    {
+    }
+    assert(journal.getNumOfMoves() == 0);
+    assert(GameState(game) == start);
+    assert(game.getHash() == hashFromScratch(game));
+
+    cout << "test_catan_undoRedo passed." << endl;
+}
+
+void test_catan_undoRedoKeepsRecord()
+{
+    Player p1("Alice"), p2("Bob"), p3("Charlie");
+    Catan game(p1, p2, p3, 707);
+    GameRecord record(game);
+    game.setRecord(&record);
+    Journal journal;
+    game.setJournal(&journal);
+    RandomBot bot;
+    Rng rng(5);
+    vector<Bot *> bots = {&bot, &bot, &bot};
+    playSetup(game, bots, rng);
+
+    // Undo one or two moves now and then, redo some of them, and play on
+    for (int step = 0; step < 1500 && !game.isGameEnded(); step++)
+    {
+        Action action = rng.below(3) ? bot.chooseAction(game, rng) : Action::rollDice();
+        game.apply(action);
+        if (rng.below(4) == 0)
+        {
+            size_t back = 1 + rng.below(2);
+            for (size_t i = 0; i < back; i++)
+            {
+                game.undo();
+            }
+            if (rng.below(2))
+            {
+                game.redo();
+            }
+        }
+    }
+    record.finish(game);
+
+    // The record replays to the game on the board, not to the moves that were taken back
+    Player q1("Alice"), q2("Bob"), q3("Charlie");
+    Catan replayed(q1, q2, q3, 707);
+    assert(record.replay(replayed) == record.getNumOfMoves());
+    assert(GameState(replayed) == GameState(game));
+
+    cout << "test_catan_undoRedoKeepsRecord passed." << endl;
+}
+
+void test_catan_longestRoad()
+{
+    Player p1("Alice"), p2("Bob"), p3("Charlie");
+    Catan game(p1, p2, p3);
+    Journal journal;
+    game.setJournal(&journal);
+    Player &alice = game.getPlayer(0);
+    alice.addResource(Resource::Brick, 10);
+    alice.addResource(Resource::Lumber, 10);
+
+    // Walk a simple path of five roads away from vertex 0
+    vector<int> path = {0}, edges;
+    while (edges.size() < 5)
+    {
+        for (int e : standardTopology().vertexEdges[path.back()])
+        {
+            const IdList<2> &ends = standardTopology().edgeVertices[e];
+            int next = ends[0] == path.back() ? ends[1] : ends[0];
+            if (find(path.begin(), path.end(), next) == path.end())
+            {
+                path.push_back(next);
+                edges.push_back(e);
+                break;
+            }
+        }
+    }
+
+    // The card goes to the first road of five, worth two points
+    assert(game.apply(Action::placeSettlement(0)) == ActionResult::Success);
+    for (size_t i = 0; i < edges.size(); i++)
+    {
+        assert(game.getLongestRoadHolder() == NO_PLAYER);
+        assert(game.apply(Action::placeRoad(edges[i])) == ActionResult::Success);
+        assert(game.getBoard().getLongestRoad(0) == (int)i + 1);
+    }
+    assert(game.getLongestRoadHolder() == 0);
+    assert(alice.hasLongestRoad() && alice.getPoints() == 3);
+    assert(GameState(game).players[0].roadLength == 5);
+
+    // Another player's settlement in the middle cuts the road and takes the card away
+    assert(game.apply(Action::endTurn()) == ActionResult::Success);
+    assert(game.apply(Action::placeSettlement(path[3])) == ActionResult::Success);
+    assert(game.getBoard().getLongestRoad(0) == 3);
+    assert(game.getLongestRoadHolder() == NO_PLAYER);
+    assert(!alice.hasLongestRoad() && alice.getPoints() == 1);
+    assert(game.getHash() == hashFromScratch(game));
+
+    // Undoing the settlement mends the road and gives the card back
+    assert(game.undo());
+    assert(game.getBoard().getLongestRoad(0) == 5);
+    assert(game.getLongestRoadHolder() == 0);
+    assert(alice.getPoints() == 3);
+    assert(game.getHash() == hashFromScratch(game));
+
+    cout << "test_catan_longestRoad passed." << endl;
+}
+
+// Edge joining two neighboring vertices
+static int edgeBetween(int a, int b)
+{
+    for (int e = 0; e < NUM_EDGES; e++)
+    {
+        const IdList<2> &ends = standardTopology().edgeVertices[e];
+        if ((ends[0] == a && ends[1] == b) || (ends[0] == b && ends[1] == a))
+        {
+            return e;
+        }
+    }
+    return -1;
+}
+
+void test_catan_roadBuildingStopsAtOpponent()
+{
+    // Alice's road runs a-b; Road Building would add b-c and then c-d, but Bob builds on c
+    int a = 0;
+    int b = standardTopology().vertexVertices[a][0];
+    int c = standardTopology().vertexVertices[b][0] == a ? standardTopology().vertexVertices[b][1] : standardTopology().vertexVertices[b][0];
+    int d = standardTopology().vertexVertices[c][0] == b ? standardTopology().vertexVertices[c][1] : standardTopology().vertexVertices[c][0];
+
+    Player p1("Alice"), p2("Bob"), p3("Charlie");
+    Catan game(p1, p2, p3, 3);
+    assert(game.apply(Action::placeSettlement(a)) == ActionResult::Success);
+    assert(game.apply(Action::placeRoad(edgeBetween(a, b))) == ActionResult::Success);
+    game.nextPlayer();
+    assert(game.apply(Action::placeSettlement(c)) == ActionResult::Success);
+    game.nextPlayer();
+    game.nextPlayer();
+    game.getPlayer(0).addDevelopmentCard(DevCard::RoadBuilding);
+
+    GameState state(game);
+    Action through = Action::playRoadBuilding(edgeBetween(b, c), edgeBetween(c, d));
+    assert(game.apply(through) == ActionResult::NotConnected);
+    assert(state.apply(through) == ActionResult::NotConnected);
+    vector<Action> actions;
+    state.legalActions(actions);
+    for (const Action &action : actions)
+    {
+        assert(!(action.type == ActionType::PlayRoadBuilding && action.location == through.location && action.secondLocation == through.secondLocation));
+    }
+
+    // Without the settlement in the way the same roads are fine
+    Catan open(p1, p2, p3, 3);
+    assert(open.apply(Action::placeSettlement(a)) == ActionResult::Success);
+    assert(open.apply(Action::placeRoad(edgeBetween(a, b))) == ActionResult::Success);
+    open.getPlayer(0).addDevelopmentCard(DevCard::RoadBuilding);
+    assert(open.apply(through) == ActionResult::Success);
+
+    cout << "test_catan_roadBuildingStopsAtOpponent passed." << endl;
+}
+
+void test_catan_roadStopsAtOpponent()
+{
+    // Alice's road runs a-b and Bob builds on c; a plain road b-c is fine but c-d is not
+    int a = 0;
+    int b = standardTopology().vertexVertices[a][0];
+    int c = standardTopology().vertexVertices[b][0] == a ? standardTopology().vertexVertices[b][1] : standardTopology().vertexVertices[b][0];
+    int d = standardTopology().vertexVertices[c][0] == b ? standardTopology().vertexVertices[c][1] : standardTopology().vertexVertices[c][0];
+
+    Player p1("Alice"), p2("Bob"), p3("Charlie");
+    Catan game(p1, p2, p3, 3);
+    assert(game.apply(Action::placeSettlement(a)) == ActionResult::Success);
+    assert(game.apply(Action::placeRoad(edgeBetween(a, b))) == ActionResult::Success);
+    game.nextPlayer();
+    assert(game.apply(Action::placeSettlement(c)) == ActionResult::Success);
+    game.nextPlayer();
+    game.nextPlayer();
+    game.getPlayer(0).addResource(Resource::Brick, 4);
+    game.getPlayer(0).addResource(Resource::Lumber, 4);
+
+    GameState state(game);
+    Action toSettlement = Action::placeRoad(edgeBetween(b, c));
+    Action through = Action::placeRoad(edgeBetween(c, d));
+    assert(game.apply(toSettlement) == ActionResult::Success);
+    assert(state.apply(toSettlement) == ActionResult::Success);
+    assert(!game.getBoard().getLegalRoads(0).test(through.location));
+    assert(!state.getLegalRoads(0).test(through.location));
+    assert(game.apply(through) == ActionResult::NotConnected);
+    assert(state.apply(through) == ActionResult::NotConnected);
+    assert(GameState(game) == state);
+
+    // A settlement built on the end of a road takes away the roads that led on from there
+    Catan cut(p1, p2, p3, 3);
+    assert(cut.apply(Action::placeSettlement(a)) == ActionResult::Success);
+    assert(cut.apply(Action::placeRoad(edgeBetween(a, b))) == ActionResult::Success);
+    cut.getPlayer(0).addResource(Resource::Brick, 4);
+    cut.getPlayer(0).addResource(Resource::Lumber, 4);
+    assert(cut.apply(toSettlement) == ActionResult::Success);
+    assert(cut.getBoard().getLegalRoads(0).test(through.location));
+    cut.nextPlayer();
+    GameState cutState(cut);
+    assert(cut.apply(Action::placeSettlement(c)) == ActionResult::Success);
+    assert(cutState.apply(Action::placeSettlement(c)) == ActionResult::Success);
+    assert(!cut.getBoard().getLegalRoads(0).test(through.location));
+    assert(GameState(cut) == cutState);
+
+    cout << "test_catan_roadStopsAtOpponent passed." << endl;
+}
+
+void test_catan_morePlayers()
+{
+    // Setup snakes forward through the seats and back
+    SetupSchedule schedule(4);
+    assert(schedule.size() == 8);
+    size_t order[] = {0, 1, 2, 3, 3, 2, 1, 0};
+    for (size_t step = 0; step < schedule.size(); step++)
+    {
+        assert(schedule.seat(step) == order[step]);
+    }
+
+    GreedyBot greedy;
+    RandomBot random;
+    for (size_t seats : {(size_t)4, (size_t)6})
+    {
+        vector<Bot *> bots(seats, &greedy);
+        bots[1] = &random;
+        GameResult result = playGame(bots, 99, 500);
+        assert(result.points.size() == seats);
+        if (result.winner >= 0)
+        {
+            assert(result.points[(size_t)result.winner] >= 10);
+        }
+    }
+
+    // Four seats fit in a game state, and it follows the game
+    vector<Player> players = {Player("A"), Player("B"), Player("C"), Player("D")};
+    Catan game(players, 5);
+    RandomBot bot;
+    vector<Bot *> bots(4, &bot);
+    Rng rng(3);
+    playSetup(game, bots, rng);
+    GameState state(game);
+    for (int step = 0; step < 2000 && !game.isGameEnded(); step++)
+    {
+        Action action = rng.below(3) ? bot.chooseAction(game, rng) : Action::rollDice();
+        assert(game.apply(action) == state.apply(action));
+        assert(GameState(game) == state);
+    }
+
+    bool threw = false;
+    try
+    {
+        Catan alone(vector<Player>{Player("Solo")});
+    }
+    catch (const invalid_argument &)
+    {
+        threw = true;
+    }
+    assert(threw);
+
+    cout << "test_catan_morePlayers passed." << endl;
+}
+
+void test_log_sinks()
+{
+    // The ring keeps the last lines at or above the runtime level
+    RingSink ring(2);
+    Logger::setSink(&ring);
+    Logger::setLevel(LogLevel::Warn);
+    LOG_INFO("skipped");
+    LOG_WARN("first " << 1);
+    LOG_WARN("second " << 2);
+    LOG_ERROR("third " << 3);
+    assert(ring.lines() == vector<string>({"[WARN] second 2", "[ERROR] third 3"}));
+
+    // Levels below CATAN_LOG_LEVEL are compiled out, whatever the runtime level
+    Logger::setLevel(LogLevel::Trace);
+    LOG_DEBUG("debug");
+    assert(ring.lines().back() == (CATAN_LOG_LEVEL <= 1 ? "[DEBUG] debug" : "[ERROR] third 3"));
+
+    // A stream sink writes nothing until its buffer fills or it is flushed
+    ostringstream out;
+    StreamSink stream(out, 1024);
+    Logger::setSink(&stream);
+    LOG_INFO("buffered");
+    assert(out.str().empty());
+    stream.flush();
+    assert(out.str() == "[INFO] buffered\n");
+
+    // Without a sink nothing is formatted, at any level
+    Logger::setSink(nullptr);
+    int formatted = 0;
+    LOG_ERROR("counted " << ++formatted);
+    assert(!Logger::enabled(LogLevel::Error));
+    assert(formatted == 0);
+
+    Logger::setLevel(LogLevel::Info);
+    assert(parseLevel("debug") == LogLevel::Debug);
+    cout << "test_log_sinks passed." << endl;
+}
+
+void test_alloc_zeroAllocationPaths()
+{
+    Player p1("Alice"), p2("Bob"), p3("Charlie");
+    Catan game(p1, p2, p3, 8);
+    Board &board = game.getBoard();
+    assert(game.apply(Action::placeSettlement(0)) == ActionResult::Success);
+    assert(game.apply(Action::placeRoad(0)) == ActionResult::Success);
+
+    // Counting sees allocations made by the thread
+    long before = AllocationTracker::threadAllocations();
+    vector<int> *allocated = new vector<int>(4);
+    assert(AllocationTracker::threadAllocations() == before + 2);
+    delete allocated;
+
+    // Production, dice rolls, validation and placement do not allocate
+    before = AllocationTracker::threadAllocations();
+    for (int roll = 2; roll <= 12; roll++)
+    {
+        board.giveResources(game.getPlayer(0), roll);
+        game.rollDice(board);
+    }
+    assert(board.isValidSettlementLocation(30) == (board.validateSettlement(30, game.getPlayer(1), true) == ActionResult::Success));
+    assert(game.getPlayer(0).hasEnoughResources(Purchase::Road));
+    assert(game.apply(Action::placeRoad(1)) == ActionResult::Success);
+    assert(AllocationTracker::threadAllocations() == before);
+
+#ifdef CATAN_TRACK_ALLOCATIONS
+    // The instrumentation build attributes allocations to the engine's entry points
+    assert(AllocationTracker::site("Board::Board").allocations > 0);
+    assert(AllocationTracker::site("Catan::Catan").allocations > 0);
+#endif
+
+    cout << "test_alloc_zeroAllocationPaths passed." << endl;
+}
+
+void test_metrics_histogramAndCounters()
+{
+    // Percentiles are exact below 16 and within a sixteenth above
+    Histogram histogram;
+    for (uint64_t v = 1; v <= 1000; v++)
+    {
+        histogram.record(v);
+    }
+    assert(histogram.count() == 1000 && histogram.min() == 1 && histogram.max() == 1000);
+    assert(histogram.percentile(50) >= 500 && histogram.percentile(50) <= 500 + 500 / 16);
+    assert(histogram.percentile(99) >= 990 && histogram.percentile(99) <= 1000);
+    assert(histogram.percentile(1) == 10);
+
+    Metrics::reset();
+    Metrics::setEnabled(true);
+    Player p1("Alice"), p2("Bob"), p3("Charlie");
+    Catan game(p1, p2, p3, 8);
+    assert(game.apply(Action::placeSettlement(0)) == ActionResult::Success);
+    assert(game.apply(Action::placeRoad(0)) == ActionResult::Success);
+    assert(game.apply(Action::placeSettlement(1)) != ActionResult::Success);
+    Metrics::setEnabled(false);
+    assert(game.apply(Action::placeRoad(1)) == ActionResult::Success);
+
+    MetricsSnapshot snapshot = Metrics::snapshot();
+    assert(snapshot.counter(Counter::SettlementsPlaced) == 1);
+    assert(snapshot.counter(Counter::RoadsPlaced) == 1);
+    assert(snapshot.applied[(size_t)ActionType::PlaceSettlement] == 1);
+    assert(snapshot.rejected[(size_t)ActionType::PlaceSettlement] == 1);
+    assert(snapshot.latency[(size_t)ActionType::PlaceSettlement].count() == 2);
+    assert(Metrics::report(snapshot).find("PlaceRoad") != string::npos);
+    Metrics::reset();
+
+    cout << "test_metrics_histogramAndCounters passed." << endl;
+}
+
+// Checks the vectorized pair search against trying every pair one by one
+static void assertBestPair(Board &board, const VertexEvaluator &evaluator, const VertexMask &legal)
+{
+    float best = -INFINITY;
+    for (int a = 0; a < NUM_VERTICES; a++)
+    {
+        for (int b = 0; b < NUM_VERTICES; b++)
+        {
+            if (a != b && legal.test(a) && legal.test(b) && !board.getVertexNeighborMask(a).test(b))
+            {
+                best = max(best, evaluator.pairScore(a, b));
+            }
+        }
+    }
+    pair<int, int> chosen = evaluator.bestPair(legal);
+    assert(legal.test(chosen.first) && legal.test(chosen.second));
+    assert(!board.getVertexNeighborMask(chosen.first).test(chosen.second));
+    assert(evaluator.score(chosen.first) >= evaluator.score(chosen.second));
+    assert(fabs(evaluator.pairScore(chosen.first, chosen.second) - best) < 1e-3f);
+}
+
+void test_evaluator_bestPairMatchesBruteForce()
+{
+    Rng rng(5);
+    Board board(rng);
+    VertexEvaluator evaluator(board);
+    VertexMask legal = board.getLegalSettlements(0, true);
+    legal.reset(10);
+    assertBestPair(board, evaluator, legal);
+
+    int top = evaluator.bestVertex(legal);
+    for (int v = 0; v < NUM_VERTICES; v++)
+    {
+        assert(!legal.test(v) || evaluator.score(v) <= evaluator.score(top));
+    }
+    assert(evaluator.bestVertex(VertexMask()) == -1);
+    assert(evaluator.bestPair(VertexMask::single(0)).first == -1);
+
+    cout << "test_evaluator_bestPairMatchesBruteForce passed." << endl;
+}
+
+void test_evaluator_bestPairNegativeWeights()
+{
+    Rng rng(5);
+    Board board(rng);
+    VertexMask legal = board.getLegalSettlements(0, true);
+
+    // A pair that shares its resources beats one that complements, so the bound is off
+    EvaluatorWeights weights;
+    weights.complement = -2.0f;
+    VertexEvaluator sharing(board, weights);
+    assertBestPair(board, sharing, legal);
+
+    weights.complement = 0.5f;
+    weights.diversity = -3.0f;
+    VertexEvaluator narrow(board, weights);
+    assertBestPair(board, narrow, legal);
+
+    cout << "test_evaluator_bestPairNegativeWeights passed." << endl;
+}
+
+void test_simulation_playGame()
+{
+    GreedyBot greedy;
+    RandomBot random;
+    vector<Bot *> bots = {&greedy, &random, &greedy};
+
+    GameResult first = playGame(bots, 1234, 500);
+    GameResult second = playGame(bots, 1234, 500);
+    assert(first.winner == second.winner);
+    assert(first.turns == second.turns);
+    assert(first.points == second.points);
+    assert(first.produced == second.produced);
+
+    assert(first.points.size() == 3);
+    if (first.winner >= 0)
+    {
+        assert(first.points[(size_t)first.winner] >= 10);
+    }
+    for (int points : first.points)
+    {
+        // Every seat keeps at least its two setup settlements
+        assert(points >= 2);
+    }
+
+    cout << "test_simulation_playGame passed." << endl;
+}
+
+void test_simulation_legalMovesMatchValidation()
+{
+    Player p1("Alice"), p2("Bob"), p3("Charlie");
+    Catan game(p1, p2, p3, 99);
+    Board &board = game.getBoard();
+    RandomBot bot;
+    vector<Bot *> bots = {&bot, &bot, &bot};
+    Rng rng(5);
+
+    // The maintained sets must match a full scan of the placement rules at every turn
+    playSetup(game, bots, rng);
+    for (int turn = 0; turn < 60; turn++)
+    {
+        for (size_t i = 0; i < game.getNumOfPlayers(); i++)
+        {
+            Player &player = game.getPlayer(i);
+            for (int v = 0; v < board.getVerticesSize(); v++)
+            {
+                assert(board.getLegalSettlements(player.getId(), true).test(v) == (board.validateSettlement(v, player, true) == ActionResult::Success));
+                assert(board.getLegalSettlements(player.getId(), false).test(v) == (board.validateSettlement(v, player, false) == ActionResult::Success));
+                assert(board.getLegalUpgrades(player.getId()).test(v) == (board.validateUpgrade(v, player) == ActionResult::Success));
+            }
+            for (int e = 0; e < board.getEdgesSize(); e++)
+            {
+                assert(board.getLegalRoads(player.getId()).test(e) == (board.validateRoad(e, player) == ActionResult::Success));
+            }
+        }
+        playTurn(game, bot, rng);
+    }
+
+    cout << "test_simulation_legalMovesMatchValidation passed." << endl;
+}
+
+void test_scheduler_matchesPlayGame()
+{
+    // A game played one decision at a time ends like one played in one go
+    GreedyBot greedy;
+    RandomBot random;
+    vector<Bot *> bots = {&greedy, &random, &greedy, &random};
+    GameRunner runner(bots, 77, 300);
+    long slices = 0;
+    while (!runner.step(1))
+    {
+        slices++;
+    }
+    GameResult whole = playGame(bots, 77, 300);
+    assert(slices > 100);
+    assert(runner.getResult().points == whole.points);
+    assert(runner.getResult().turns == whole.turns);
+
+    // Many games interleaved on a few threads give the results of playing them alone
+    vector<string> names = {"greedy", "random", "greedy"};
+    vector<GameResult> results(40);
+    vector<size_t> moves(results.size());
+    {
+        GameScheduler scheduler(3, 7, 5);
+        for (size_t i = 0; i < results.size(); i++)
+        {
+            scheduler.submit(GameJob(100 + i, names, 300, i % 2 == 0), [&, i](const GameJob &job, const GameResult &result, const GameRecord *record) {
+                assert(job.seed == 100 + i);
+                assert((record != nullptr) == job.record);
+                results[i] = result;
+                moves[i] = record ? record->getNumOfMoves() : 0;
+            });
+        }
+        scheduler.wait();
+        assert(scheduler.pending() == 0);
+    }
+    vector<Bot *> threeBots = {&greedy, &random, &greedy};
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        GameRecord record;
+        GameResult alone = playGame(threeBots, 100 + i, 300, &record);
+        assert(results[i].winner == alone.winner);
+        assert(results[i].turns == alone.turns);
+        assert(results[i].points == alone.points);
+        assert(moves[i] == (i % 2 == 0 ? record.getNumOfMoves() : 0));
+    }
+
+    bool threw = false;
+    try
+    {
+        GameScheduler scheduler(1);
+        scheduler.submit(GameJob(1, {"greedy", "nobody"}));
+    }
+    catch (const invalid_argument &)
+    {
+        threw = true;
+    }
+    assert(threw);
+
+    cout << "test_scheduler_matchesPlayGame passed." << endl;
+}
+
+void test_rating_eloAndPairings()
+{
+    // Four entries: four groups of three, each in three seat rotations
+    vector<vector<size_t>> pairings = roundRobinPairings(4, 3);
+    assert(pairings.size() == 12);
+    vector<vector<int>> seatCounts(4, vector<int>(3, 0));
+    for (const vector<size_t> &seats : pairings)
+    {
+        for (size_t seat = 0; seat < seats.size(); seat++)
+        {
+            seatCounts[seats[seat]][seat]++;
+        }
+    }
+    for (const vector<int> &counts : seatCounts)
+    {
+        assert(counts[0] == 3 && counts[1] == 3 && counts[2] == 3);
+    }
+
+    // The winner gains from both opponents, the runner-up wins one and loses one, and the ratings keep their sum
+    EloRatings ratings(4);
+    GameResult result;
+    result.winner = 2;
+    result.turns = 50;
+    result.points = {4, 7, 10};
+    ratings.update({3, 0, 1}, result);
+    assert(ratings.getRating(1) > 1500.0 && ratings.getRating(0) == 1500.0);
+    assert(ratings.getRating(3) < 1500.0 && ratings.getRating(2) == 1500.0);
+    assert(fabs(ratings.getRating(0) + ratings.getRating(1) + ratings.getRating(3) - 4500.0) < 1e-9);
+    assert(ratings.getWins(1) == 1 && ratings.getGames(2) == 0 && ratings.getPoints(3) == 4);
+    vector<size_t> standings = ratings.standings();
+    assert(standings.front() == 1 && standings.back() == 3);
+
+    // A Swiss round of five entries in groups of three: everyone plays, neighbors by rating
+    Rng rng(5);
+    EloRatings five(5);
+    five.update({0, 1, 2}, result);
+    vector<vector<size_t>> round = swissPairings(five, 3, rng);
+    assert(round.size() == 2);
+    vector<int> plays(5, 0);
+    for (const vector<size_t> &seats : round)
+    {
+        assert(seats.size() == 3);
+        for (size_t entry : seats)
+        {
+            plays[entry]++;
+        }
+    }
+    for (int count : plays)
+    {
+        assert(count >= 1);
+    }
+    assert(find(round[0].begin(), round[0].end(), (size_t)2) != round[0].end());
+
+    cout << "test_rating_eloAndPairings passed." << endl;
+}
+
+void test_record_replayMatchesGame()
+{
+    GreedyBot greedy;
+    RandomBot random;
+    vector<Bot *> bots = {&greedy, &random, &greedy};
+    GameRecord record;
+    GameResult result = playGame(bots, 4321, 500, &record);
+    assert(record.getSeed() == 4321);
+    assert(record.getNumOfMoves() > 0);
+    assert(record.getSizeInBytes() < 3 * record.getNumOfMoves());
+
+    // A record survives a round trip through a stream and replays to the same game
+    stringstream archive;
+    record.write(archive);
+    record.write(archive);
+    GameRecord loaded;
+    assert(loaded.read(archive));
+    Player p1("Seat 1"), p2("Seat 2"), p3("Seat 3");
+    Catan game(p1, p2, p3, loaded.getSeed());
+    assert(loaded.replay(game) == record.getNumOfMoves());
+    for (size_t i = 0; i < game.getNumOfPlayers(); i++)
+    {
+        assert(game.getPlayer(i).getPoints() == result.points[i]);
+    }
+    assert(loaded.read(archive));
+    assert(!loaded.read(archive));
+
+    // Replaying on a game with another seed is refused
+    Catan other(p1, p2, p3, 1234);
+    bool refused = false;
+    try
+    {
+        record.replay(other);
+    }
+    catch (const runtime_error &)
+    {
+        refused = true;
+    }
+    assert(refused);
+
+    cout << "test_record_replayMatchesGame passed." << endl;
+}
+
+// Reads a record from bytes and replays it on a fresh game; false if either step throws
+static bool replaysCleanly(const string &bytes)
+{
+    try
+    {
+        stringstream in(bytes);
+        GameRecord record;
+        record.read(in);
+        Player p1("Seat 1"), p2("Seat 2"), p3("Seat 3");
+        Catan game(p1, p2, p3, record.getSeed());
+        record.replay(game);
+        return true;
+    }
+    catch (const runtime_error &)
+    {
+        return false;
+    }
+}
+
+void test_record_rejectsCorruptMoves()
+{
+    // One trade: the op, the partner, the two resources in a byte and the two amounts
+    Player p1("Seat 1"), p2("Seat 2"), p3("Seat 3");
+    Catan game(p1, p2, p3, 77);
+    GameRecord record(game);
+    game.setRecord(&record);
+    assert(game.apply(Action::trade(1, Resource::Brick, Resource::Lumber, 2, 1)) == ActionResult::Success);
+    record.finish(game);
+    stringstream out;
+    record.write(out);
+    const string bytes = out.str();
+    assert(replaysCleanly(bytes));
+
+    // The moves start after the 33-byte header and the two one-byte lengths, and end before the hash
+    const size_t moves = 35;
+    assert(bytes.size() == moves + 5 + 8);
+    string badSeat = bytes;
+    badSeat[moves + 1] = 9;
+    assert(!replaysCleanly(badSeat));
+    string badResource = bytes;
+    badResource[moves + 2] = 0x72;
+    assert(!replaysCleanly(badResource));
+    string badAmount = bytes.substr(0, moves + 3) + "\xff\xff\x03" + bytes.substr(moves + 4);
+    badAmount[34] = 7;
+    assert(!replaysCleanly(badAmount));
+
+    // A huge length is refused, and a large one runs into the end of the stream
+    assert(!replaysCleanly(bytes.substr(0, 34) + "\xff\xff\xff\xff\x0f" + bytes.substr(35)));
+    assert(!replaysCleanly(bytes.substr(0, 34) + "\x80\x80\x80\x04" + bytes.substr(35)));
+
+    // A knight sale paid in a value that is not a resource is refused as it is read
+    Player q1("Seat 1"), q2("Seat 2"), q3("Seat 3");
+    Catan sale(q1, q2, q3, 77);
+    GameRecord forged(sale);
+    forged.recordAction(Action::buyKnight(1, 1, (Resource)200, 1));
+    forged.finish(sale);
+    stringstream forgedOut;
+    forged.write(forgedOut);
+    assert(!replaysCleanly(forgedOut.str()));
+
+    // The engine refuses values that are not resources, whoever sends them
+    GameState state(game);
+    Action monopoly = Action::playMonopoly((Resource)9);
+    assert(game.apply(monopoly) == ActionResult::InvalidTrade);
+    assert(state.apply(monopoly) == ActionResult::InvalidTrade);
+    Action plenty = Action::playYearOfPlenty(Resource::Ore, (Resource)NUM_RESOURCES);
+    assert(game.apply(plenty) == ActionResult::InvalidTrade);
+    assert(state.apply(plenty) == ActionResult::InvalidTrade);
+    Action trade = Action::trade(1, (Resource)200, Resource::Ore, 1, 1);
+    assert(game.apply(trade) == ActionResult::InvalidTrade);
+    assert(state.apply(trade) == ActionResult::InvalidTrade);
+    game.getPlayer(1).addKnights(2);
+    state = GameState(game);
+    Action knights = Action::buyKnight(1, 1, (Resource)200, 1);
+    assert(game.apply(knights) == ActionResult::InvalidTrade);
+    assert(state.apply(knights) == ActionResult::InvalidTrade);
+    assert(GameState(game) == state);
+
+    cout << "test_record_rejectsCorruptMoves passed." << endl;
+}
+
+void test_gamestate_matchesCatan()
+{
+    Player p1("Alice"), p2("Bob"), p3("Charlie");
+    Catan game(p1, p2, p3, 2024);
+    RandomBot bot;
+    vector<Bot *> bots = {&bot, &bot, &bot};
+    Rng rng(11);
+    playSetup(game, bots, rng);
+
+    // Apply the same actions, including illegal ones, to the game and to a snapshot of it
+    GameState state(game);
+    assert(sizeof(GameState) < 1024);
+    for (int step = 0; step < 5000 && !game.isGameEnded(); step++)
+    {
+        Action action;
+        switch (rng.below(4))
+        {
+        case 0:
+            action = Action::rollDice();
+            break;
+        case 1:
+            action = bot.chooseAction(game, rng);
+            break;
+        case 2:
+            action = Action::trade((int)rng.below(4), (Resource)rng.below(5), (Resource)rng.below(5), (int)rng.below(3), (int)rng.below(3));
+            break;
+        default:
+            action = rng.below(2) ? Action::sellKnight((int)rng.below(3), 1, (Resource)rng.below(5), 1)
+                                  : Action::placeSettlement((int)rng.below(60));
+        }
+        assert(game.apply(action) == state.apply(action));
+        assert(GameState(game) == state);
+    }
+    assert(game.isGameEnded() == state.isGameEnded());
+
+    // A restored game is identical to the one the state was taken from
+    Player q1("Dan"), q2("Eve"), q3("Frank");
+    Catan other(q1, q2, q3, 1);
+    state.restore(other);
+    assert(GameState(other) == state);
+    assert(other.getPlayer(0).getName() == "Dan");
+    assert(other.getPlayer(1).getPoints() == game.getPlayer(1).getPoints());
+
+    cout << "test_gamestate_matchesCatan passed." << endl;
+}
+
+void test_gamestate_restoreStartsHistoryOver()
+{
+    Player p1("Alice"), p2("Bob"), p3("Charlie");
+    Catan game(p1, p2, p3, 808);
+    GameRecord record(game);
+    game.setRecord(&record);
+    Journal journal;
+    game.setJournal(&journal);
+    RandomBot bot;
+    vector<Bot *> bots = {&bot, &bot, &bot};
+    Rng rng(9);
+    playSetup(game, bots, rng);
+    GameState early(game);
+    for (int turn = 0; turn < 10 && !game.isGameEnded(); turn++)
+    {
+        playTurn(game, bot, rng);
+    }
+
+    // The moves before the jump cannot be undone, and the record stops where it was
+    size_t recorded = record.getNumOfMoves();
+    early.restore(game);
+    assert(GameState(game) == early);
+    assert(!game.undo());
+    assert(game.apply(Action::rollDice()) == ActionResult::Success);
+    assert(record.getNumOfMoves() == recorded);
+
+    // Moves after it are journaled against the restored position
+    assert(game.undo());
+    assert(GameState(game) == early);
+    assert(!game.undo());
+
+    cout << "test_gamestate_restoreStartsHistoryOver passed." << endl;
+}
+
+void test_snapshot_saveAndMap()
+{
+    // Positions from the setup to late in a game
+    Player p1("Alice"), p2("Bob"), p3("Charlie"), p4("Dana");
+    Catan game(vector<Player>{p1, p2, p3, p4}, 31);
+    RandomBot bot;
+    vector<Bot *> bots(4, &bot);
+    Rng rng(8);
+    playSetup(game, bots, rng);
+    vector<GameState> states;
+    for (int turn = 0; turn < 60 && !game.isGameEnded(); turn++)
+    {
+        playTurn(game, bot, rng);
+        if (turn % 20 == 0)
+        {
+            states.push_back(GameState(game));
+        }
+    }
+
+    const string path = "test_snapshot.bin";
+    saveSnapshots(path, states);
+    {
+        SnapshotFile file(path);
+        assert(file.size() == states.size());
+        for (size_t i = 0; i < file.size(); i++)
+        {
+            assert(file[i] == states[i]);
+        }
+        assert(&file.at(1) == &file[1]);
+        bool threw = false;
+        try
+        {
+            file.at(file.size());
+        }
+        catch (const out_of_range &)
+        {
+            threw = true;
+        }
+        assert(threw);
+
+        // A mapped position resumes into a game and plays on like the original
+        Catan resumed(vector<Player>{Player("W"), Player("X"), Player("Y"), Player("Z")}, 1);
+        file[file.size() - 1].restore(resumed);
+        assert(GameState(resumed) == states.back());
+        GameState copy = file[file.size() - 1];
+        assert(copy.apply(Action::rollDice()) == resumed.apply(Action::rollDice()));
+        assert(GameState(resumed) == copy);
+    }
+
+    // A file cut short is refused
+    {
+        SnapshotWriter writer(path);
+        writer.write(states[0]);
+    }
+    assert(truncate(path.c_str(), (off_t)(sizeof(SnapshotHeader) + sizeof(GameState) / 2)) == 0);
+    bool threw = false;
+    try
+    {
+        SnapshotFile file(path);
+    }
+    catch (const runtime_error &)
+    {
+        threw = true;
+    }
+    assert(threw);
+    remove(path.c_str());
+
+#ifdef __linux__
+    // A write that fails is reported as soon as the stream sees it, not left for the destructor
+    threw = false;
+    try
+    {
+        SnapshotWriter writer("/dev/full");
+        for (int i = 0; i < 1000; i++)
+        {
+            writer.write(states[0]);
+        }
+        writer.close();
+    }
+    catch (const runtime_error &)
+    {
+        threw = true;
+    }
+    assert(threw);
+#endif
+
+    cout << "test_snapshot_saveAndMap passed." << endl;
+}
+
+void test_mcts_searchReturnsLegalAction()
+{
+    Player p1("Alice"), p2("Bob"), p3("Charlie");
+    Catan game(p1, p2, p3, 77);
+    GreedyBot greedy;
+    vector<Bot *> bots = {&greedy, &greedy, &greedy};
+    Rng rng(3);
+    playSetup(game, bots, rng);
+
+    MctsConfig config;
+    config.iterations = 200;
+    config.threads = 2;
+    MctsBot bot(config);
+
+    // Every decision over the first turns is a legal action, reached with the full iteration budget
+    int searches = 0;
+    for (int turn = 0; turn < 30 && !game.isGameEnded(); turn++)
+    {
+        game.apply(Action::rollDice());
+        for (int i = 0; i < MAX_ACTIONS_PER_TURN && !game.isGameEnded(); i++)
+        {
+            GameState before(game);
+            Action action = bot.chooseAction(game, rng);
+            assert(GameState(game) == before);
+            if (action.type == ActionType::EndTurn)
+            {
+                break;
+            }
+            assert(bot.getStatistics().playouts >= config.iterations);
+            assert(game.apply(action) == ActionResult::Success);
+            searches++;
+        }
+        game.endTurn();
+    }
+    assert(searches > 0);
+
+    // A finished game has nothing to search
+    for (int i = 0; i < 10; i++)
+    {
+        game.getPlayer(0).addDevelopmentCard(DevCard::VictoryPoint);
+    }
+    GameState ended(game);
+    assert(ended.isGameEnded());
+    assert(bot.search(ended, 1).type == ActionType::EndTurn);
+    assert(bot.getStatistics().playouts == 0);
+
+    cout << "test_mcts_searchReturnsLegalAction passed." << endl;
+}
+
+void test_player_itsSeven()
+{
+    Rng rng(7);
+    Player player("Alice");
+    player.addResource(Resource::Ore, 6);
+    assert(player.getTotalResources() == 10);
+
+    player.itsSeven(rng);
+    assert(player.getTotalResources() == 5);
+
+    // Players with 7 or fewer resources keep them all
+    player.itsSeven(rng);
+    assert(player.getTotalResources() == 5);
+
+    cout << "test_player_itsSeven passed." << endl;
+}
+
 int main()
 {
     // Board tests
@@ -536,6 +1938,12 @@ int main()
     test_board_getTile();
     test_board_getVertex();
     test_board_isConnectedToPlayerSettlement();
+    test_board_roadConnectsToRoad();
+    test_board_roadSupply();
+    test_board_giveResources();
+    test_board_bitboards();
+    test_board_topologyIsConsistent();
+    test_board_generatedTopology();
 
     // Player tests
     test_player_getName();
@@ -553,6 +1961,8 @@ int main()
     test_player_getResource();
     test_player_removeResource();
     test_player_getAmountOfDevCards();
+    test_player_resourceArrays();
+    test_player_itsSeven();
 
     // Catan tests
     test_catan_ChooseStartingPlayer();
@@ -565,6 +1975,51 @@ int main()
     test_catan_getCurrentPlayer();
     test_catan_findPlayerByName();
     test_catan_buyDevelopmentCard();
+    test_catan_applyPlaceSettlementAndRoad();
+    test_catan_applyTurnAndTrade();
+    test_catan_seededGamesAreReproducible();
+    test_catan_incrementalHash();
+    test_catan_undoRedo();
+    test_catan_undoRedoKeepsRecord();
+    test_catan_longestRoad();
+    test_catan_roadBuildingStopsAtOpponent();
+    test_catan_roadStopsAtOpponent();
+    test_catan_morePlayers();
+
+    // Log tests
+    test_log_sinks();
+
+    // Allocation tests
+    test_alloc_zeroAllocationPaths();
+
+    // Metrics tests
+    test_metrics_histogramAndCounters();
+
+    // Evaluator tests
+    test_evaluator_bestPairMatchesBruteForce();
+    test_evaluator_bestPairNegativeWeights();
+
+    // Simulation tests
+    test_simulation_playGame();
+    test_simulation_legalMovesMatchValidation();
+    test_scheduler_matchesPlayGame();
+
+    // Rating tests
+    test_rating_eloAndPairings();
+
+    // Record tests
+    test_record_replayMatchesGame();
+    test_record_rejectsCorruptMoves();
+
+    // Game state tests
+    test_gamestate_matchesCatan();
+    test_gamestate_restoreStartsHistoryOver();
+
+    // Snapshot tests
+    test_snapshot_saveAndMap();
+
+    // MCTS tests
+    test_mcts_searchReturnsLegalAction();
 
     cout << "All tests passed!" << endl;
     return 0;
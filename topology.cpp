@@ -0,0 +1,284 @@
+#include "topology.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+
+namespace ariel
+{
+
+    // Tiles are pointy-topped. A tile at (q, r) is centered at x = 2q + r, y = 3r,
+    // which puts every corner on integer coordinates: these are its offsets,
+    // clockwise from the top.
+    static const int CORNER_X[6] = {0, 1, 1, 0, -1, -1};
+    static const int CORNER_Y[6] = {-2, -1, 1, 2, 1, -1};
+
+    static int floorDiv(int a, int b)
+    {
+        return a >= 0 ? a / b : -((-a + b - 1) / b);
+    }
+
+    // Zigzag line of vertices that a corner at height y lies on: the bottom corners of
+    // one row of tiles and the top corners of the next share a line
+    static int lineOf(int y)
+    {
+        return floorDiv(y + 2, 3);
+    }
+
+    template <size_t N>
+    static void addUnique(IdList<N, uint16_t> &list, int id)
+    {
+        for (int existing : list)
+        {
+            if (existing == id)
+            {
+                return;
+            }
+        }
+        list.ids[list.count++] = (uint16_t)id;
+    }
+
+    template <size_t N>
+    static void sortLists(vector<IdList<N, uint16_t>> &lists)
+    {
+        for (auto &list : lists)
+        {
+            sort(list.ids, list.ids + list.count);
+        }
+    }
+
+    /**
+     * Generates the topology of a set of tiles.
+     *
+     * @param shape The axial coordinates of the tiles, each at most once.
+     * @throws invalid_argument if the shape is empty or repeats a tile.
+     */
+    HexTopology::HexTopology(const vector<HexCoord> &shape) : tiles(shape)
+    {
+        if (tiles.empty())
+        {
+            throw invalid_argument("A board needs at least one tile");
+        }
+        sort(tiles.begin(), tiles.end(), [](const HexCoord &a, const HexCoord &b) {
+            return a.r != b.r ? a.r < b.r : a.q < b.q;
+        });
+        for (size_t t = 1; t < tiles.size(); t++)
+        {
+            if (tiles[t].q == tiles[t - 1].q && tiles[t].r == tiles[t - 1].r)
+            {
+                throw invalid_argument("A board cannot repeat a tile");
+            }
+        }
+
+        // Corner positions, numbered by line and then from left to right
+        vector<pair<pair<int, int>, int>> corners; // ((line, x), y)
+        for (const HexCoord &tile : tiles)
+        {
+            for (size_t c = 0; c < 6; c++)
+            {
+                int x = 2 * tile.q + tile.r + CORNER_X[c];
+                int y = 3 * tile.r + CORNER_Y[c];
+                corners.push_back(make_pair(make_pair(lineOf(y), x), y));
+            }
+        }
+        sort(corners.begin(), corners.end());
+        corners.erase(unique(corners.begin(), corners.end()), corners.end());
+        map<pair<int, int>, int> vertexAt; // (x, y) to vertex ID
+        for (size_t v = 0; v < corners.size(); v++)
+        {
+            vertexAt[make_pair(corners[v].first.second, corners[v].second)] = (int)v;
+        }
+
+        vector<array<int, 6>> cornerIds(tiles.size());
+        for (size_t t = 0; t < tiles.size(); t++)
+        {
+            for (size_t c = 0; c < 6; c++)
+            {
+                int x = 2 * tiles[t].q + tiles[t].r + CORNER_X[c];
+                int y = 3 * tiles[t].r + CORNER_Y[c];
+                cornerIds[t][c] = vertexAt[make_pair(x, y)];
+            }
+        }
+
+        // Sides, numbered by line: the sides along a line by their middle, then the
+        // vertical sides that lead down to the next line
+        vector<pair<pair<int, int>, pair<int, int>>> sides; // ((order, x), (low ID, high ID))
+        for (size_t t = 0; t < tiles.size(); t++)
+        {
+            for (size_t c = 0; c < 6; c++)
+            {
+                int a = cornerIds[t][c];
+                int b = cornerIds[t][(c + 1) % 6];
+                const auto &first = corners[(size_t)min(a, b)].first;
+                const auto &second = corners[(size_t)max(a, b)].first;
+                pair<int, int> order = first.first == second.first ? make_pair(2 * first.first, first.second + second.second)
+                                                                   : make_pair(2 * first.first + 1, 2 * first.second);
+                sides.push_back(make_pair(order, make_pair(min(a, b), max(a, b))));
+            }
+        }
+        sort(sides.begin(), sides.end());
+        sides.erase(unique(sides.begin(), sides.end()), sides.end());
+        map<pair<int, int>, int> edgeBetween;
+        for (size_t e = 0; e < sides.size(); e++)
+        {
+            edgeBetween[sides[e].second] = (int)e;
+        }
+
+        vertexVertices.assign(corners.size(), List3());
+        vertexEdges.assign(corners.size(), List3());
+        vertexTiles.assign(corners.size(), List3());
+        edgeVertices.assign(sides.size(), List2());
+        edgeEdges.assign(sides.size(), List4());
+        tileVertices.assign(tiles.size(), List6());
+        tileEdges.assign(tiles.size(), List6());
+
+        for (size_t t = 0; t < tiles.size(); t++)
+        {
+            for (size_t c = 0; c < 6; c++)
+            {
+                int v = cornerIds[t][c];
+                addUnique(tileVertices[t], v);
+                addUnique(vertexTiles[(size_t)v], (int)t);
+            }
+        }
+        for (size_t e = 0; e < sides.size(); e++)
+        {
+            int a = sides[e].second.first;
+            int b = sides[e].second.second;
+            addUnique(edgeVertices[e], a);
+            addUnique(edgeVertices[e], b);
+            addUnique(vertexVertices[(size_t)a], b);
+            addUnique(vertexVertices[(size_t)b], a);
+            addUnique(vertexEdges[(size_t)a], (int)e);
+            addUnique(vertexEdges[(size_t)b], (int)e);
+        }
+        for (size_t e = 0; e < sides.size(); e++)
+        {
+            for (int v : edgeVertices[e])
+            {
+                for (int other : vertexEdges[(size_t)v])
+                {
+                    if (other != (int)e)
+                    {
+                        addUnique(edgeEdges[e], other);
+                    }
+                }
+            }
+        }
+        for (size_t t = 0; t < tiles.size(); t++)
+        {
+            for (size_t c = 0; c < 6; c++)
+            {
+                int a = cornerIds[t][c];
+                int b = cornerIds[t][(c + 1) % 6];
+                addUnique(tileEdges[t], edgeBetween[make_pair(min(a, b), max(a, b))]);
+            }
+        }
+
+        sortLists(vertexVertices);
+        sortLists(vertexEdges);
+        sortLists(vertexTiles);
+        sortLists(edgeEdges);
+        sortLists(tileVertices);
+        sortLists(tileEdges);
+    }
+
+    /**
+     * Returns the topology of a shape, generating it the first time the shape is asked for.
+     * Later calls with the same tiles, in any order, return the same object.
+     *
+     * @param shape The axial coordinates of the tiles.
+     * @return The topology, which lives until the program ends.
+     */
+    const HexTopology &HexTopology::forShape(const vector<HexCoord> &shape)
+    {
+        static mutex cacheLock;
+        static map<vector<pair<int, int>>, unique_ptr<HexTopology>> cache;
+
+        vector<pair<int, int>> key;
+        for (const HexCoord &tile : shape)
+        {
+            key.push_back(make_pair(tile.r, tile.q));
+        }
+        sort(key.begin(), key.end());
+
+        lock_guard<mutex> guard(cacheLock);
+        unique_ptr<HexTopology> &entry = cache[key];
+        if (!entry)
+        {
+            entry.reset(new HexTopology(shape));
+        }
+        return *entry;
+    }
+
+    const HexTopology &HexTopology::hexagon(int radius)
+    {
+        return forShape(hexagonShape(radius));
+    }
+
+    vector<HexCoord> HexTopology::hexagonShape(int radius)
+    {
+        if (radius < 0)
+        {
+            throw invalid_argument("The radius of a board cannot be negative");
+        }
+        vector<HexCoord> shape;
+        for (int r = -radius; r <= radius; r++)
+        {
+            for (int q = -radius; q <= radius; q++)
+            {
+                if (abs(q + r) <= radius)
+                {
+                    shape.push_back({q, r});
+                }
+            }
+        }
+        return shape;
+    }
+
+    // Copies generated lists into a table of byte IDs
+    template <size_t N>
+    static void narrow(IdList<N> *to, const vector<IdList<N, uint16_t>> &from)
+    {
+        for (size_t i = 0; i < from.size(); i++)
+        {
+            to[i].count = from[i].count;
+            for (size_t j = 0; j < N; j++)
+            {
+                to[i].ids[j] = (uint8_t)from[i].ids[j];
+            }
+        }
+    }
+
+    /**
+     * Generates the standard board and narrows its lists to byte IDs.
+     *
+     * @throws logic_error if the generated board does not have the standard size.
+     */
+    Topology::Topology()
+    {
+        const HexTopology &topology = HexTopology::hexagon(STANDARD_RADIUS);
+        if (topology.numTiles() != NUM_TILES || topology.numVertices() != NUM_VERTICES || topology.numEdges() != NUM_EDGES)
+        {
+            throw logic_error("The standard board does not have the expected size");
+        }
+        narrow(vertexVertices, topology.vertexVertices);
+        narrow(vertexEdges, topology.vertexEdges);
+        narrow(vertexTiles, topology.vertexTiles);
+        narrow(edgeVertices, topology.edgeVertices);
+        narrow(edgeEdges, topology.edgeEdges);
+        narrow(tileVertices, topology.tileVertices);
+        narrow(tileEdges, topology.tileEdges);
+    }
+
+    const Topology &standardTopology()
+    {
+        static const Topology topology;
+        return topology;
+    }
+}
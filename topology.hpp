@@ -0,0 +1,102 @@
+#ifndef TOPOLOGY_HPP
+#define TOPOLOGY_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+using namespace std;
+
+namespace ariel
+{
+
+    // Size of the standard board
+    const int NUM_TILES = 19;
+    const int NUM_VERTICES = 54;
+    const int NUM_EDGES = 72;
+
+    // Radius of the standard board, in tiles around the center one
+    const int STANDARD_RADIUS = 2;
+
+    // Short list of location IDs with a fixed capacity, so tables of them are flat arrays.
+    // The standard board fits its IDs in a byte; larger boards use 16-bit IDs.
+    template <size_t N, typename Id = uint8_t>
+    struct IdList
+    {
+        uint8_t count;
+        Id ids[N];
+
+        const Id *begin() const { return ids; }
+        const Id *end() const { return ids + count; }
+        size_t size() const { return count; }
+        int operator[](size_t i) const { return ids[i]; }
+    };
+
+    // Position of a tile in axial hex coordinates: q grows to the right and r downwards,
+    // so a row of tiles shares r
+    struct HexCoord
+    {
+        int q;
+        int r;
+    };
+
+    // The adjacency of a board of any shape, generated from the axial coordinates of its
+    // tiles. Tiles are numbered row by row from the top, left to right. Vertices are
+    // numbered along the zigzag lines that run between the rows of tiles, and edges along
+    // those lines with the vertical edges between two lines after the line above them.
+    // Every list is in increasing order. For the standard board this is the numbering
+    // the rest of the engine uses.
+    class HexTopology
+    {
+    public:
+        typedef IdList<3, uint16_t> List3;
+        typedef IdList<2, uint16_t> List2;
+        typedef IdList<4, uint16_t> List4;
+        typedef IdList<6, uint16_t> List6;
+
+        vector<HexCoord> tiles;      // Coordinates of each tile
+        vector<List3> vertexVertices; // Vertices one edge away from each vertex
+        vector<List3> vertexEdges;    // Edges touching each vertex
+        vector<List3> vertexTiles;    // Tiles around each vertex
+        vector<List2> edgeVertices;   // End points of each edge
+        vector<List4> edgeEdges;      // Edges sharing a vertex with each edge
+        vector<List6> tileVertices;   // Corners of each tile
+        vector<List6> tileEdges;      // Sides of each tile
+
+        // Generates the topology of the given tiles; their order does not matter
+        explicit HexTopology(const vector<HexCoord> &shape);
+
+        int numTiles() const { return (int)tiles.size(); }
+        int numVertices() const { return (int)vertexVertices.size(); }
+        int numEdges() const { return (int)edgeVertices.size(); }
+
+        // Topology of a shape, generated on first use and shared afterwards
+        static const HexTopology &forShape(const vector<HexCoord> &shape);
+
+        // Topology of the hexagonal board with the given radius; radius 2 is the standard board
+        static const HexTopology &hexagon(int radius);
+
+        // Tiles within a radius of the center tile
+        static vector<HexCoord> hexagonShape(int radius);
+    };
+
+    // The adjacency of the standard board: HexTopology::hexagon(STANDARD_RADIUS) copied
+    // into flat tables of byte IDs that every Board shares
+    struct Topology
+    {
+        IdList<3> vertexVertices[NUM_VERTICES]; // Vertices one edge away from each vertex
+        IdList<3> vertexEdges[NUM_VERTICES];    // Edges touching each vertex
+        IdList<3> vertexTiles[NUM_VERTICES];    // Tiles around each vertex, in row-by-row tile order
+        IdList<2> edgeVertices[NUM_EDGES];      // End points of each edge
+        IdList<4> edgeEdges[NUM_EDGES];         // Edges sharing a vertex with each edge
+        IdList<6> tileVertices[NUM_TILES];      // Corners of each tile
+        IdList<6> tileEdges[NUM_TILES];         // Sides of each tile
+
+        Topology();
+    };
+
+    // Returns the adjacency of the standard board, generated on first use
+    const Topology &standardTopology();
+}
+
+#endif
@@ -0,0 +1,215 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+
+#include "rating.hpp"
+#include "scheduler.hpp"
+
+using namespace std;
+using namespace ariel;
+
+// Seats in every tournament game
+const size_t SEATS = 3;
+
+// Splits a comma separated list of bot names
+vector<string> splitNames(const string &list)
+{
+    vector<string> names;
+    size_t start = 0;
+    while (start <= list.size())
+    {
+        size_t end = list.find(',', start);
+        if (end == string::npos)
+        {
+            end = list.size();
+        }
+        names.push_back(list.substr(start, end - start));
+        start = end + 1;
+    }
+    return names;
+}
+
+void usage()
+{
+    cerr << "Usage: tournament --bots a,b,c,... [--format round-robin|swiss] [--games N] [--rounds R]" << endl;
+    cerr << "                  [--threads T] [--seed S] [--max-turns M] [--k K]" << endl;
+    cerr << "Bots: random, greedy, mcts; an entry may appear more than once" << endl;
+    exit(1);
+}
+
+/**
+ * Rates a roster of bots against each other in 3-player games on all cores.
+ * A round robin plays every three entries in every seat rotation, --games times over.
+ * A Swiss tournament plays --rounds rounds, each grouping entries of similar rating,
+ * --games games per group. Ratings are updated as each game finishes, so the final
+ * numbers depend slightly on the order in which the threads finish their games;
+ * the games themselves are reproducible from the seed.
+ */
+int main(int argc, char *argv[])
+{
+    string botList;
+    string format = "round-robin";
+    long gamesPerPairing = 1;
+    int rounds = 20;
+    unsigned numOfThreads = thread::hardware_concurrency();
+    uint64_t seed = Rng::randomSeed();
+    int maxTurns = 500;
+    double k = 32.0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (i + 1 >= argc)
+        {
+            usage();
+        }
+        if (strcmp(argv[i], "--bots") == 0)
+        {
+            botList = argv[++i];
+        }
+        else if (strcmp(argv[i], "--format") == 0)
+        {
+            format = argv[++i];
+        }
+        else if (strcmp(argv[i], "--games") == 0)
+        {
+            gamesPerPairing = atol(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--rounds") == 0)
+        {
+            rounds = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--threads") == 0)
+        {
+            numOfThreads = (unsigned)atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--seed") == 0)
+        {
+            seed = strtoull(argv[++i], nullptr, 10);
+        }
+        else if (strcmp(argv[i], "--max-turns") == 0)
+        {
+            maxTurns = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--k") == 0)
+        {
+            k = atof(argv[++i]);
+        }
+        else
+        {
+            usage();
+        }
+    }
+    if (numOfThreads == 0)
+    {
+        numOfThreads = 1;
+    }
+    if (format != "round-robin" && format != "swiss")
+    {
+        cerr << "Unknown format: " << format << endl;
+        usage();
+    }
+
+    vector<string> roster = splitNames(botList);
+    if (roster.size() < SEATS)
+    {
+        cerr << "A tournament needs at least " << SEATS << " entries" << endl;
+        usage();
+    }
+    for (const string &name : roster)
+    {
+        if (!createBot(name))
+        {
+            cerr << "Unknown bot: " << name << endl;
+            usage();
+        }
+    }
+
+    // Entries with the same strategy are told apart by their position in the roster
+    vector<string> labels;
+    for (size_t i = 0; i < roster.size(); i++)
+    {
+        labels.push_back(roster[i] + "#" + to_string(i + 1));
+    }
+
+    EloRatings ratings(roster.size(), 1500.0, k);
+    mutex ratingsLock;
+    long played = 0;
+    uint64_t nextSeed = seed;
+    auto start = chrono::steady_clock::now();
+    {
+        GameScheduler scheduler(numOfThreads);
+        auto submit = [&](const vector<size_t> &seats)
+        {
+            vector<string> bots;
+            for (size_t entry : seats)
+            {
+                bots.push_back(roster[entry]);
+            }
+            scheduler.submit(GameJob(nextSeed++, bots, maxTurns), [&, seats](const GameJob &, const GameResult &result, const GameRecord *)
+                             {
+                lock_guard<mutex> guard(ratingsLock);
+                ratings.update(seats, result);
+                played++; });
+        };
+
+        if (format == "round-robin")
+        {
+            vector<vector<size_t>> pairings = roundRobinPairings(roster.size(), SEATS);
+            for (long game = 0; game < gamesPerPairing; game++)
+            {
+                for (const vector<size_t> &seats : pairings)
+                {
+                    submit(seats);
+                }
+            }
+        }
+        else
+        {
+            // Each round is paired from the ratings after the previous one
+            Rng rng(seed);
+            for (int round = 0; round < rounds; round++)
+            {
+                vector<vector<size_t>> pairings;
+                {
+                    lock_guard<mutex> guard(ratingsLock);
+                    pairings = swissPairings(ratings, SEATS, rng);
+                }
+                for (long game = 0; game < gamesPerPairing; game++)
+                {
+                    for (const vector<size_t> &seats : pairings)
+                    {
+                        submit(seats);
+                    }
+                }
+                scheduler.wait();
+            }
+        }
+        scheduler.wait();
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    cout << fixed << setprecision(2);
+    cout << "Games:      " << played << " (" << format << ", seed " << seed << ", " << numOfThreads << " threads)" << endl;
+    cout << "Standings:" << endl;
+    cout << "  " << left << setw(4) << "#" << setw(12) << "Entry" << right << setw(9) << "Elo" << setw(8) << "Games"
+         << setw(9) << "Win %" << setw(12) << "Avg points" << endl;
+    vector<size_t> order = ratings.standings();
+    for (size_t rank = 0; rank < order.size(); rank++)
+    {
+        size_t entry = order[rank];
+        long games = ratings.getGames(entry);
+        cout << "  " << left << setw(4) << rank + 1 << setw(12) << labels[entry] << right << setw(9) << ratings.getRating(entry)
+             << setw(8) << games
+             << setw(9) << (games ? 100.0 * (double)ratings.getWins(entry) / (double)games : 0.0)
+             << setw(12) << (games ? (double)ratings.getPoints(entry) / (double)games : 0.0) << endl;
+    }
+    cout << "Games/sec:  " << (seconds > 0 ? (double)played / seconds : 0.0) << endl;
+    return 0;
+}
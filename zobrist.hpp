@@ -0,0 +1,90 @@
+#ifndef ZOBRIST_HPP
+#define ZOBRIST_HPP
+
+#include <cstdint>
+
+using namespace std;
+
+namespace ariel
+{
+
+    // Zobrist keys for the features of a position. The hash of a position is the XOR
+    // of the keys of all its features, so changing one feature costs two XORs.
+    // Instead of being drawn into fixed tables, every key is the splitmix64 mix of the
+    // feature's coordinates: the same feature always gets the same key, and there is no
+    // upper bound on hand sizes or on the number of players.
+    namespace zobrist
+    {
+        // Kinds of features, kept apart in the top byte of the mixed value
+        enum class Feature : uint64_t
+        {
+            Settlement = 1,
+            City,
+            Road,
+            Resource,
+            DevCard,
+            KnightsLeft,
+            VictoryPointsLeft,
+            CurrentPlayer,
+            LongestRoad
+        };
+
+        // Key of a feature: kind, owner (16 bits), location or type (16 bits), count (24 bits)
+        inline uint64_t key(Feature feature, uint64_t owner, uint64_t index, uint64_t count)
+        {
+            uint64_t z = ((uint64_t)feature << 56) ^ ((owner & 0xFFFF) << 40) ^ ((index & 0xFFFF) << 24) ^ (count & 0xFFFFFF);
+            z += 0x9E3779B97F4A7C15ULL;
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            return z ^ (z >> 31);
+        }
+
+        inline uint64_t settlement(int vertexId, uint8_t player)
+        {
+            return key(Feature::Settlement, player, (uint64_t)vertexId, 0);
+        }
+
+        inline uint64_t city(int vertexId, uint8_t player)
+        {
+            return key(Feature::City, player, (uint64_t)vertexId, 0);
+        }
+
+        inline uint64_t road(int edgeId, uint8_t player)
+        {
+            return key(Feature::Road, player, (uint64_t)edgeId, 0);
+        }
+
+        // An empty pile contributes nothing, so a player with no cards hashes to 0
+        inline uint64_t resource(uint8_t player, size_t resource, int count)
+        {
+            return count == 0 ? 0 : key(Feature::Resource, player, resource, (uint64_t)(uint32_t)count);
+        }
+
+        inline uint64_t devCard(uint8_t player, size_t card, int count)
+        {
+            return count == 0 ? 0 : key(Feature::DevCard, player, card, (uint64_t)(uint32_t)count);
+        }
+
+        inline uint64_t knightsLeft(int count)
+        {
+            return key(Feature::KnightsLeft, 0, 0, (uint64_t)(uint32_t)count);
+        }
+
+        inline uint64_t victoryPointsLeft(int count)
+        {
+            return key(Feature::VictoryPointsLeft, 0, 0, (uint64_t)(uint32_t)count);
+        }
+
+        inline uint64_t currentPlayer(size_t player)
+        {
+            return key(Feature::CurrentPlayer, player, 0, 0);
+        }
+
+        inline uint64_t longestRoad(uint8_t holder)
+        {
+            return key(Feature::LongestRoad, holder, 0, 0);
+        }
+    }
+}
+
+#endif